@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/TagRenderCache.h"
+
+// Stand-ins for the NeoRadar host APIs the stand pipeline talks to.
+// Same call shapes as the PluginSDK ones used by the plugin, backed by plain containers.
+namespace bench {
+
+struct StubAircraft {
+    std::string callsign;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    int groundSpeed = 0;
+};
+
+class StubAircraftAPI {
+public:
+    void add(StubAircraft aircraft) { aircraft_[aircraft.callsign] = std::move(aircraft); }
+
+    std::optional<StubAircraft> getByCallsign(const std::string& callsign) const
+    {
+        auto it = aircraft_.find(callsign);
+        if (it == aircraft_.end()) return std::nullopt;
+        return it->second;
+    }
+
+    // Walks the aircraft without copying them, so the bench host adds no allocation of its own
+    template <typename Fn>
+    void forEach(Fn&& fn) const
+    {
+        for (const auto& [callsign, aircraft] : aircraft_) fn(aircraft);
+    }
+
+    std::vector<StubAircraft> getAll() const
+    {
+        std::vector<StubAircraft> all;
+        all.reserve(aircraft_.size());
+        for (const auto& [callsign, aircraft] : aircraft_) all.push_back(aircraft);
+        return all;
+    }
+
+private:
+    std::unordered_map<std::string, StubAircraft> aircraft_;
+};
+
+struct StubFlightplan {
+    std::string callsign;
+    std::string origin;
+    std::string destination;
+    std::string acType;
+};
+
+class StubFlightplanAPI {
+public:
+    void add(StubFlightplan flightplan) { flightplans_.push_back(std::move(flightplan)); }
+
+    std::optional<StubFlightplan> getByCallsign(const std::string& callsign) const
+    {
+        for (const StubFlightplan& flightplan : flightplans_) {
+            if (flightplan.callsign == callsign) return flightplan;
+        }
+        return std::nullopt;
+    }
+
+    const std::vector<StubFlightplan>& getAll() const { return flightplans_; }
+
+private:
+    std::vector<StubFlightplan> flightplans_;
+};
+
+// Counts what would have crossed into the host
+class StubTagInterface {
+public:
+    void UpdateTagValue(const std::string& tagId, const std::string& value, const rampAgent::TagRenderCache::Colour&)
+    {
+        ++calls;
+        bytes += tagId.size() + value.size();
+    }
+
+    size_t calls = 0;
+    size_t bytes = 0;
+};
+
+} // namespace bench
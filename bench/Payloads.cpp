@@ -0,0 +1,138 @@
+#include "Payloads.h"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <nlohmann/json.hpp>
+
+#include "core/OccupancyParser.h"
+
+namespace bench {
+
+namespace {
+
+const char* const AIRLINES[] = { "AFR", "EZY", "RYR", "DLH", "BAW", "KLM", "TRA", "VLG", "SWR", "IBE" };
+const char* const TYPES[] = { "A320", "A321", "B738", "E190", "A20N", "B77W", "A359", "AT76", "CRJ9", "B789" };
+const char* const ORIGINS[] = { "LFMN", "EGLL", "EDDF", "LEMD", "EHAM", "KJFK", "LFBO", "LIRF", "OMDB", "LSZH" };
+
+rampAgent::Stand makeStand(const std::string& icao, std::string name, double latitude, double longitude)
+{
+    rampAgent::Stand stand;
+    stand.name = std::move(name);
+    stand.icao = icao;
+    stand.sortKey = rampAgent::StandSortKey::from(stand.name);
+    stand.hasPosition = true;
+    stand.latitude = latitude;
+    stand.longitude = longitude;
+    stand.radius = 30.0;
+    return stand;
+}
+
+nlohmann::json entryJson(const std::string& callsign, const std::string& stand, const std::string& icao)
+{
+    return { { "callsign", callsign }, { "name", stand }, { "remark", "" }, { "icao", icao } };
+}
+
+} // namespace
+
+Scene makeSyntheticScene(size_t aircraftCount, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    Scene scene;
+    scene.icao = "LFPG";
+
+    // Realistic names: bare numbers, lettered stands and apron prefixes
+    const size_t standCount = aircraftCount + aircraftCount / 2 + 20;
+    for (size_t i = 0; i < standCount; ++i) {
+        std::string name;
+        switch (i % 4) {
+        case 0: name = std::to_string(i / 4 + 1); break;
+        case 1: name = std::to_string(i / 4 + 1) + "A"; break;
+        case 2: name = std::to_string(i / 4 + 1) + "B"; break;
+        default: name = std::string(1, static_cast<char>('E' + (i / 4) % 6)) + std::to_string(i / 24 + 1); break;
+        }
+        scene.stands.push_back(makeStand(scene.icao, name, 49.0 + static_cast<double>(i) * 0.0004, 2.55));
+    }
+    std::shuffle(scene.stands.begin(), scene.stands.end(), rng);
+
+    nlohmann::json assigned = nlohmann::json::array();
+    nlohmann::json occupied = nlohmann::json::array();
+    nlohmann::json blocked = nlohmann::json::array();
+    std::vector<std::string> callsigns;
+
+    for (size_t i = 0; i < aircraftCount; ++i) {
+        const std::string callsign = std::string(AIRLINES[i % 10]) + std::to_string(100 + i);
+        const rampAgent::Stand& stand = scene.stands[i];
+        callsigns.push_back(callsign);
+
+        // Two thirds inbound with a stand assigned, the rest parked on theirs
+        const bool parked = i % 3 == 2;
+        (parked ? occupied : assigned).push_back(entryJson(callsign, stand.name, scene.icao));
+        // A few parked aircraft still carry an assignment elsewhere, the occupied stand wins
+        if (parked && i % 30 == 2) assigned.push_back(entryJson(callsign, scene.stands[i - 1].name, scene.icao));
+        scene.aircraft.add({ callsign, parked ? stand.latitude : 48.5, parked ? stand.longitude : 2.0, parked ? 0 : 250 });
+        scene.flightplans.add({ callsign, ORIGINS[i % 10], scene.icao, TYPES[i % 10] });
+    }
+    for (size_t i = aircraftCount; i < aircraftCount + aircraftCount / 20; ++i) {
+        blocked.push_back({ { "name", scene.stands[i].name }, { "icao", scene.icao } });
+    }
+
+    nlohmann::json full = { { "version", 1 }, { "assignedStands", assigned }, { "occupiedStands", occupied }, { "blockedStands", blocked } };
+    scene.fullBody = full.dump();
+
+    // About 2% of the assignments move to a free stand
+    nlohmann::json changed = nlohmann::json::array();
+    const size_t changes = std::max<size_t>(1, aircraftCount / 50);
+    for (size_t i = 0; i < changes && i * 3 < aircraftCount; ++i) {
+        const size_t freeStand = aircraftCount + aircraftCount / 20 + i;
+        if (freeStand >= scene.stands.size()) break;
+        changed.push_back(entryJson(callsigns[i * 3], scene.stands[freeStand].name, scene.icao));
+    }
+    nlohmann::json delta = { { "version", 2 }, { "delta", true }, { "assignedStands", { { "changed", changed } } } };
+    scene.deltaBody = delta.dump();
+    return scene;
+}
+
+bool makeRecordedScene(const std::string& path, Scene& scene, std::string& error)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::ostringstream body;
+    body << file.rdbuf();
+
+    rampAgent::OccupancyDocument document;
+    if (!rampAgent::parseOccupancy(body.str(), document, &error)) return false;
+
+    scene = Scene();
+    scene.fullBody = body.str();
+    scene.icao = "ZZZZ";
+    for (const auto& entry : document.entries) {
+        if (!entry.icao.empty()) {
+            scene.icao = entry.icao;
+            break;
+        }
+    }
+
+    // Every stand the recording mentions, plus as many free ones
+    std::set<std::string> names;
+    for (const auto& entry : document.entries) {
+        names.insert(entry.stand);
+        if (!entry.callsign.empty()) {
+            scene.aircraft.add({ entry.callsign, 0.0, 0.0, 0 });
+            scene.flightplans.add({ entry.callsign, "", scene.icao, "A320" });
+        }
+    }
+    const size_t known = names.size();
+    for (size_t i = 0; i < known; ++i) names.insert("FREE" + std::to_string(i));
+    for (const std::string& name : names) scene.stands.push_back(makeStand(scene.icao, name, 0.0, 0.0));
+
+    std::shuffle(scene.stands.begin(), scene.stands.end(), std::mt19937(42));
+    return true;
+}
+
+} // namespace bench
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BenchStubs.h"
+#include "core/StandCatalogue.h"
+
+namespace bench {
+
+// One airport with its traffic, as the plugin would see it after a poll
+struct Scene {
+    std::string icao;
+    std::vector<rampAgent::Stand> stands; // unsorted, as read from the stand JSON
+    std::string fullBody;                 // /api/occupancy/ answer
+    std::string deltaBody;                // a few changes on top of fullBody
+    StubAircraftAPI aircraft;
+    StubFlightplanAPI flightplans;
+};
+
+// Deterministic scene with aircraftCount aircraft and about 1.5 stands per aircraft
+Scene makeSyntheticScene(size_t aircraftCount, uint32_t seed = 42);
+
+// Scene around a recorded occupancy body: aircraft and stands are derived from its entries
+bool makeRecordedScene(const std::string& path, Scene& scene, std::string& error);
+
+} // namespace bench
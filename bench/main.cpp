@@ -0,0 +1,498 @@
+// NeoRampAgentBench: times the stand pipeline outside the NeoRadar host.
+//
+//   NeoRampAgentBench [--iterations N] [--payload recorded.json] [--no-http]
+//
+// Scenes of 10, 500 and 5000 aircraft are generated, or one scene is built
+// around a recorded /api/occupancy/ body. Each stage reports median and p90.
+// Exits with 1 when a steady cycle sends tag values, a steady tag pass over an
+// unchanged snapshot allocates, the disk cache does not read back what it wrote,
+// identical full bodies do not slow polling down or the occupancy stream fails
+// against the local SSE stub.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include <httplib.h>
+
+#include "BenchStubs.h"
+#include "Payloads.h"
+#include "core/AirportSubscription.h"
+#include "core/ApiClient.h"
+#include "core/DiskCache.h"
+#include "core/OccupancyParser.h"
+#include "core/OccupancyStream.h"
+#include "core/PollInterval.h"
+#include "core/StandCatalogue.h"
+#include "core/StandStateEngine.h"
+
+using namespace rampAgent;
+
+// Every heap allocation of the process is counted, for the steady-state check
+static std::atomic<size_t> g_allocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+template <typename Fn>
+void measure(const char* stage, const std::string& scene, int iterations, Fn&& fn)
+{
+    fn(); // warm-up, fills caches and allocator pools
+
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    std::printf("%-22s %-14s %12.1f %12.1f\n", stage, scene.c_str(),
+        samples[samples.size() / 2], samples[samples.size() * 9 / 10]);
+}
+
+// The radar client as seen by the engine, answered from the scene
+class SceneHost : public EngineHost {
+public:
+    explicit SceneHost(const bench::Scene& scene) : scene_(scene)
+    {
+        auto catalogue = std::make_shared<StandCatalogue>();
+        catalogue->icao = scene.icao;
+        catalogue->stands = scene.stands;
+        catalogue->revision = 1;
+        sortStandList(catalogue->stands);
+        catalogue_ = std::move(catalogue);
+    }
+
+    bool isOnScope(const std::string& callsign) const override { return scene_.aircraft.getByCallsign(callsign).has_value(); }
+
+    void callsignsOnScope(std::vector<std::string>& callsigns) const override
+    {
+        callsigns.clear();
+        scene_.aircraft.forEach([&callsigns](const bench::StubAircraft& aircraft) { callsigns.push_back(aircraft.callsign); });
+    }
+
+    std::string destinationOf(const std::string& callsign) const override
+    {
+        auto flightplan = scene_.flightplans.getByCallsign(callsign);
+        return flightplan ? flightplan->destination : std::string();
+    }
+
+    std::vector<Flight> flights() const override
+    {
+        std::vector<Flight> flights;
+        for (const auto& flightplan : scene_.flightplans.getAll()) {
+            auto aircraft = scene_.aircraft.getByCallsign(flightplan.callsign);
+            if (!aircraft) continue;
+            flights.push_back({ flightplan.callsign, flightplan.origin, flightplan.destination, flightplan.acType,
+                aircraft->latitude, aircraft->longitude, static_cast<double>(aircraft->groundSpeed) });
+        }
+        return flights;
+    }
+
+    std::vector<AircraftPosition> positions() const override
+    {
+        std::vector<AircraftPosition> positions;
+        for (const auto& aircraft : scene_.aircraft.getAll()) {
+            positions.push_back({ aircraft.callsign, aircraft.latitude, aircraft.longitude, static_cast<double>(aircraft.groundSpeed) });
+        }
+        return positions;
+    }
+
+    std::vector<std::shared_ptr<const StandCatalogue>> catalogues() const override { return { catalogue_ }; }
+
+    void pushTag(const TagRenderCache::Update& update) override
+    {
+        if (update.fields & TagRenderCache::STAND) tags.UpdateTagValue("TAG_STAND", update.standName, update.colour);
+        if (update.fields & TagRenderCache::REMARK) tags.UpdateTagValue("TAG_REMARK", update.remark, update.colour);
+    }
+
+    const StandCatalogue& catalogue() const { return *catalogue_; }
+
+    bench::StubTagInterface tags;
+
+private:
+    const bench::Scene& scene_;
+    std::shared_ptr<const StandCatalogue> catalogue_;
+};
+
+// The post-network half of runScopeUpdate(): document to snapshot to tag values
+struct ScopePipeline {
+    explicit ScopePipeline(const bench::Scene& scene) : host(scene), engine(host) {}
+
+    SceneHost host;
+    StandStateEngine engine;
+
+    void run(const std::string& body)
+    {
+        OccupancyResponse response;
+        parseOccupancy(body, response.document);
+        response.kind = response.document.delta ? OccupancyResponse::Kind::Delta : OccupancyResponse::Kind::Full;
+        engine.ingest(std::move(response));
+    }
+
+    void runAirport(const std::string& icao, const std::string& body)
+    {
+        std::map<std::string, OccupancyResponse> responses;
+        OccupancyResponse& response = responses[icao];
+        parseOccupancy(body, response.document);
+        response.kind = response.document.delta ? OccupancyResponse::Kind::Delta : OccupancyResponse::Kind::Full;
+        engine.ingestAirports(std::move(responses));
+    }
+};
+
+// Returns false when a steady cycle sent tag values, a steady tag pass allocated
+// or the disk cache round trip differed
+bool benchScene(const std::string& label, const bench::Scene& scene, int iterations)
+{
+    measure("sortStandList", label, iterations, [&] {
+        std::vector<Stand> stands = scene.stands;
+        sortStandList(stands);
+    });
+
+    OccupancyDocument document;
+    measure("parse full", label, iterations, [&] { parseOccupancy(scene.fullBody, document); });
+    if (!scene.deltaBody.empty()) {
+        OccupancyDocument delta;
+        measure("parse delta", label, iterations, [&] { parseOccupancy(scene.deltaBody, delta); });
+    }
+
+    auto airport = std::make_shared<AirportOccupancy>();
+    airport->icao = scene.icao;
+    airport->entries = document.entries;
+    airport->received = true;
+    measure("index build", label, iterations, [&] {
+        airport->takenStands.clear();
+        StandStateEngine::buildIndex(*airport);
+    });
+    OccupancySnapshot snapshot;
+    snapshot.airports[scene.icao] = airport;
+    snapshot.received = true;
+
+    // updateStandMenuButtons(): presorted catalogue filtered against the index
+    ScopePipeline menu{ scene };
+    menu.engine.updateLocalOccupancy();
+    std::vector<const Stand*> available;
+    measure("dropdown filter", label, iterations, [&] {
+        available = menu.engine.availableStands(menu.host.catalogue(), snapshot);
+    });
+
+    // First cycle pushes every tag, later identical cycles push nothing
+    measure("scope update (cold)", label, iterations, [&] {
+        ScopePipeline pipeline{ scene };
+        pipeline.run(scene.fullBody);
+    });
+    ScopePipeline steady{ scene };
+    steady.run(scene.fullBody);
+    measure("scope update (steady)", label, iterations, [&] { steady.run(scene.fullBody); });
+    const size_t pushedBefore = steady.host.tags.calls;
+    steady.run(scene.fullBody);
+    const size_t steadyPushes = steady.host.tags.calls - pushedBefore;
+    std::printf("%-22s %-14s tag values sent in a steady cycle: %zu%s\n",
+        "", label.c_str(), steadyPushes, steadyPushes ? " FAILED" : "");
+
+    // Tag pass over an unchanged snapshot: interned ids and reused maps, no heap allocation
+    measure("tag pass (steady)", label, iterations, [&] { steady.engine.refreshTags(); });
+    const size_t allocationsBefore = g_allocations.load();
+    for (int i = 0; i < iterations; ++i) steady.engine.refreshTags();
+    const size_t allocations = g_allocations.load() - allocationsBefore;
+    std::printf("%-22s %-14s heap allocations in %d steady tag passes: %zu%s\n",
+        "", label.c_str(), iterations, allocations, allocations ? " FAILED" : "");
+
+    // Background suggestion pass: every inbound ranked against the steady snapshot
+    measure("suggestions", label, iterations, [&] { steady.engine.updateSuggestions(5); });
+
+    // Warm start: catalogue and snapshot written, then mapped back in
+    const std::string cachePath = (std::filesystem::temp_directory_path() / ("NeoRampAgentBench-" + label + ".bin")).string();
+    std::shared_ptr<const OccupancySnapshot> cached = steady.engine.snapshot();
+    const std::vector<std::shared_ptr<const StandCatalogue>> catalogues = steady.host.catalogues();
+    measure("disk cache write", label, iterations, [&] { DiskCache::write(cachePath, catalogues, cached.get()); });
+    std::optional<DiskCacheContents> restored;
+    measure("disk cache read", label, iterations, [&] { restored = DiskCache::read(cachePath); });
+    bool roundTrip = restored && restored->snapshot && cached && restored->catalogues.size() == 1 &&
+        restored->catalogues[0]->stands.size() == catalogues[0]->stands.size() &&
+        restored->snapshot->airports.size() == cached->airports.size();
+    if (roundTrip) {
+        const AirportOccupancy& before = *cached->airports.at(scene.icao);
+        const AirportOccupancy& after = *restored->snapshot->airports.at(scene.icao);
+        roundTrip = after.restored && after.entries.size() == before.entries.size();
+        for (size_t i = 0; roundTrip && i < before.entries.size(); ++i) {
+            roundTrip = after.entries[i].callsign == before.entries[i].callsign && after.entries[i].stand == before.entries[i].stand;
+        }
+        for (size_t i = 0; roundTrip && i < catalogues[0]->stands.size(); ++i) {
+            const Stand& stand = catalogues[0]->stands[i];
+            roundTrip = restored->catalogues[0]->stands[i].name == stand.name &&
+                after.takenStands.contains(scene.icao, stand.name) == before.takenStands.contains(scene.icao, stand.name);
+        }
+    }
+    std::printf("%-22s %-14s disk cache round trip: %s, %ju bytes\n", "", label.c_str(), roundTrip ? "identical" : "FAILED",
+        static_cast<uintmax_t>(std::filesystem::file_size(cachePath)));
+    std::filesystem::remove(cachePath);
+
+    // A quiet satellite field refreshed next to the hub, only its own part is rebuilt
+    ScopePipeline hub{ scene };
+    hub.runAirport(scene.icao, scene.fullBody);
+    const std::string satellite = R"({"version":1,"assignedStands":[{"callsign":"SAT101","name":"1","icao":"ZSAT"}]})";
+    measure("satellite refresh", label, iterations, [&] { hub.runAirport("ZSAT", satellite); });
+
+    if (!scene.deltaBody.empty()) {
+        // Second full cycle settles new tags from yellow to white before the delta
+        ScopePipeline pipeline{ scene };
+        pipeline.run(scene.fullBody);
+        const size_t first = pipeline.host.tags.calls;
+        pipeline.run(scene.fullBody);
+        const size_t settled = pipeline.host.tags.calls;
+        pipeline.run(scene.deltaBody);
+        std::printf("%-22s %-14s tag values sent: %zu first cycle, %zu settled, %zu after a delta\n",
+            "", label.c_str(), first, settled - first, pipeline.host.tags.calls - settled);
+    }
+    return allocations == 0 && steadyPushes == 0 && roundTrip;
+}
+
+// Identical full bodies, as sent by a server without ETag or deltas, must read as
+// unchanged so the interval of a quiet field grows; a delta brings it back down.
+// Returns false when either does not happen.
+bool benchPollInterval(const std::string& label, const bench::Scene& scene)
+{
+    static constexpr int POLLS = PollInterval::QUIET_AFTER + 4;
+
+    ScopePipeline pipeline(scene);
+    PollInterval interval;
+    AirportSubscription subscription; // as the plugin schedules each followed airport
+    const auto now = AirportSubscription::Clock::now();
+    subscription.update({ scene.icao }, now);
+    OccupancyDocument document;
+    for (int i = 0; i < POLLS; ++i) {
+        parseOccupancy(scene.fullBody, document);
+        const bool changed = pipeline.engine.changesAirport(scene.icao, document);
+        interval.onSuccess(changed, 0);
+        subscription.onModified(scene.icao, "", "", document.version, changed, 0, now);
+        pipeline.runAirport(scene.icao, scene.fullBody);
+    }
+    const PollInterval::Duration quiet = interval.current();
+    const auto scheduled = std::chrono::duration_cast<PollInterval::Duration>(subscription.untilNext(now));
+    std::printf("%-22s %-14s %d identical full bodies: %llds, airport due in %llds\n", "poll interval", label.c_str(), POLLS,
+        static_cast<long long>(quiet.count()), static_cast<long long>(scheduled.count()));
+    const bool backedOff = quiet > PollInterval::DEFAULT_BASE && scheduled == quiet;
+    if (scene.deltaBody.empty()) return backedOff; // recordings have no delta
+
+    parseOccupancy(scene.deltaBody, document);
+    interval.onSuccess(pipeline.engine.changesAirport(scene.icao, document), 0);
+    const PollInterval::Duration busy = interval.current();
+    std::printf("%-22s %-14s then a delta: %llds\n", "", label.c_str(), static_cast<long long>(busy.count()));
+    return backedOff && busy < PollInterval::DEFAULT_BASE;
+}
+
+// Local plain-HTTP stand-in for the Ramp Agent server
+void benchHttp(const bench::Scene& scene, int iterations)
+{
+    httplib::Server server;
+    server.Get("/api/occupancy/", [&scene](const httplib::Request&, httplib::Response& res) {
+        res.set_content(scene.fullBody, "application/json");
+    });
+    const int port = server.bind_to_any_port("127.0.0.1");
+    if (port <= 0) {
+        std::printf("HTTP stub could not bind, skipped\n");
+        return;
+    }
+    std::thread listener([&server] { server.listen_after_bind(); });
+    server.wait_until_ready();
+
+    const std::string url = "http://127.0.0.1:" + std::to_string(port);
+    const std::string label = std::to_string(scene.fullBody.size() / 1024) + " KiB body";
+
+    ApiClient pooled(url);
+    measure("http pooled client", label, iterations, [&] { pooled.get("/api/occupancy/?callsign=BENCH"); });
+    measure("http client per call", label, iterations, [&] {
+        httplib::Client client(url);
+        client.Get("/api/occupancy/?callsign=BENCH");
+    });
+
+    server.stop();
+    listener.join();
+}
+
+// One text/event-stream event, a data line per body line
+std::string sseEvent(const std::string& event, const std::string& body)
+{
+    std::string text = "event: " + event + "\n";
+    size_t start = 0;
+    while (start <= body.size()) {
+        size_t end = body.find('\n', start);
+        if (end == std::string::npos) end = body.size();
+        text.append("data: ").append(body, start, end - start).push_back('\n');
+        start = end + 1;
+    }
+    text.push_back('\n');
+    return text;
+}
+
+// OccupancyStream against a local stub: events split across chunks, a refused
+// stream and stop() during a blocking read. Returns false when any check fails.
+bool benchStream(const bench::Scene& scene)
+{
+    static constexpr size_t CHUNK_SIZE = 997; // odd on purpose, cuts lines and field names
+    static constexpr auto EVENT_TIMEOUT = std::chrono::seconds(5);
+    static constexpr auto BACKOFF_WINDOW = std::chrono::milliseconds(500);
+    static constexpr auto STOP_LIMIT = std::chrono::seconds(1); // OccupancyStream::READ_TIMEOUT_S otherwise
+
+    const std::string events = ": heartbeat\n\n" + sseEvent("occupancy", scene.fullBody) + sseEvent("occupancy", scene.deltaBody);
+    std::atomic<bool> release{ false };
+    std::atomic<int> refusedRequests{ 0 };
+
+    httplib::Server server;
+    server.Get("/api/occupancy/stream", [&](const httplib::Request&, httplib::Response& res) {
+        res.set_chunked_content_provider("text/event-stream", [&](size_t, httplib::DataSink& sink) {
+            for (size_t offset = 0; offset < events.size(); offset += CHUNK_SIZE) {
+                if (!sink.write(events.data() + offset, std::min(CHUNK_SIZE, events.size() - offset))) return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1)); // one read per chunk
+            }
+            // Then stay silent, the client sits in a blocking read
+            while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            sink.done();
+            return true;
+        });
+    });
+    server.Get("/api/occupancy/refused", [&](const httplib::Request&, httplib::Response& res) {
+        ++refusedRequests;
+        res.status = 503;
+        res.set_content("streaming disabled", "text/plain");
+    });
+    const int port = server.bind_to_any_port("127.0.0.1");
+    if (port <= 0) {
+        std::printf("SSE stub could not bind, skipped\n");
+        return true;
+    }
+    std::thread listener([&server] { server.listen_after_bind(); });
+    server.wait_until_ready();
+
+    const std::string url = "http://127.0.0.1:" + std::to_string(port);
+    const std::string label = std::to_string(events.size() / CHUNK_SIZE + 1) + " chunks";
+    auto stopTime = [](OccupancyStream& stream) {
+        const auto start = std::chrono::steady_clock::now();
+        stream.stop();
+        return std::chrono::steady_clock::now() - start;
+    };
+    auto ms = [](std::chrono::steady_clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    // Full document then delta, each event cut across several chunks
+    ScopePipeline pipeline(scene);
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<OccupancyResponse::Kind> ingested;
+    bool rejected = false;
+    OccupancyStream stream(
+        [&](const std::string& event, const std::string& data) {
+            if (event != "occupancy") return;
+            OccupancyResponse response;
+            const bool parsed = parseOccupancy(data, response.document);
+            response.kind = response.document.delta ? OccupancyResponse::Kind::Delta : OccupancyResponse::Kind::Full;
+            const OccupancyResponse::Kind kind = response.kind;
+            const bool accepted = parsed && pipeline.engine.ingest(std::move(response));
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (accepted) ingested.push_back(kind);
+            else rejected = true;
+            cv.notify_all();
+        },
+        nullptr);
+    stream.start(url, "/api/occupancy/stream?callsign=BENCH");
+    bool delivered;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait_for(lock, EVENT_TIMEOUT, [&] { return rejected || ingested.size() >= 2; });
+        delivered = !rejected && ingested == std::vector<OccupancyResponse::Kind>{ OccupancyResponse::Kind::Full, OccupancyResponse::Kind::Delta };
+    }
+    const bool wasConnected = stream.connected();
+    const auto blockingStop = stopTime(stream);
+    std::printf("%-22s %-14s full then delta ingested: %s, connected: %s\n",
+        "sse stream", label.c_str(), delivered ? "yes" : "no", wasConnected ? "yes" : "no");
+    std::printf("%-22s %-14s stop() during a blocking read: %.1f ms\n", "", "", ms(blockingStop));
+
+    // A refused stream keeps the plugin polling and is not retried at once
+    std::atomic<bool> everConnected{ false };
+    OccupancyStream refused(nullptr, [&everConnected](bool connected) { everConnected = everConnected || connected; });
+    refused.start(url, "/api/occupancy/refused?callsign=BENCH");
+    const auto deadline = std::chrono::steady_clock::now() + EVENT_TIMEOUT;
+    while (refusedRequests == 0 && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    std::this_thread::sleep_for(BACKOFF_WINDOW);
+    const int requests = refusedRequests;
+    const bool polling = !everConnected && !refused.connected();
+    const auto backoffStop = stopTime(refused);
+    std::printf("%-22s %-14s refused with 503: polling %s, %d request(s) in %lld ms, stop() %.1f ms\n",
+        "", "", polling ? "kept" : "suspended", requests, static_cast<long long>(BACKOFF_WINDOW.count()), ms(backoffStop));
+
+    release = true;
+    server.stop();
+    listener.join();
+    return delivered && wasConnected && blockingStop < STOP_LIMIT && polling && requests == 1 && backoffStop < STOP_LIMIT;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int iterations = 50;
+    std::string payload;
+    bool http = true;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--iterations") && i + 1 < argc) iterations = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--payload") && i + 1 < argc) payload = argv[++i];
+        else if (!std::strcmp(argv[i], "--no-http")) http = false;
+        else {
+            std::fprintf(stderr, "usage: %s [--iterations N] [--payload recorded.json] [--no-http]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("%-22s %-14s %12s %12s\n", "stage", "scene", "median us", "p90 us");
+
+    if (!payload.empty()) {
+        bench::Scene scene;
+        std::string error;
+        if (!bench::makeRecordedScene(payload, scene, error)) {
+            std::fprintf(stderr, "cannot replay %s: %s\n", payload.c_str(), error.c_str());
+            return 1;
+        }
+        bool passed = benchScene("recorded", scene, iterations);
+        passed &= benchPollInterval("recorded", scene);
+        if (http) {
+            benchHttp(scene, iterations);
+            passed &= benchStream(scene);
+        }
+        return passed ? 0 : 1;
+    }
+
+    bool passed = true;
+    for (size_t aircraft : { 10, 500, 5000 }) {
+        const bench::Scene scene = bench::makeSyntheticScene(aircraft);
+        passed &= benchScene(std::to_string(aircraft) + " aircraft", scene, iterations);
+        passed &= benchPollInterval(std::to_string(aircraft) + " aircraft", scene);
+    }
+    if (http) {
+        const bench::Scene scene = bench::makeSyntheticScene(500);
+        benchHttp(scene, iterations);
+        passed &= benchStream(scene);
+    }
+    return passed ? 0 : 1;
+}
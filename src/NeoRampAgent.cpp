@@ -1,7 +1,10 @@
 #include "NeoRampAgent.h"
 #include <numeric>
+#include <set>
 #include <chrono>
+#include <cmath>
 #include <httplib.h>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <openssl/sha.h>
@@ -20,11 +23,12 @@
 
 using namespace rampAgent;
 
-NeoRampAgent::NeoRampAgent() : m_stop(false), controllerDataAPI_(nullptr) {};
+NeoRampAgent::NeoRampAgent() : controllerDataAPI_(nullptr) {};
 NeoRampAgent::~NeoRampAgent() = default;
 
 void NeoRampAgent::Initialize(const PluginMetadata& metadata, CoreAPI* coreAPI, ClientInformation info)
 {
+	const StartupTasks::Clock::time_point loadedAt = StartupTasks::Clock::now();
 	metadata_ = metadata;
 	clientInfo_ = info;
 	CoreAPI* lcoreAPI = coreAPI;
@@ -38,24 +42,24 @@ void NeoRampAgent::Initialize(const PluginMetadata& metadata, CoreAPI* coreAPI,
 	tagInterface_ = lcoreAPI->tag().getInterface();
 	packageAPI_ = &lcoreAPI->package();
 
-#ifndef DEV
-	try {
-		std::pair<bool, std::string> updateAvailable = newVersionAvailable();
-		if (updateAvailable.first) {
-			DisplayMessage("A new version of NeoRampAgent is available: " + updateAvailable.second + " (current version: " + NEORAMPAGENT_VERSION + ")", "");
-		}
-	} catch (const std::exception& e) {
-		logger_->error("Error checking for updates: " + std::string(e.what()));
-	}
-#endif // !DEV
-
-
 	try
 	{
 		this->RegisterTagActions();
 		this->RegisterTagItems();
 		this->RegisterCommand();
 
+		assignmentQueue_ = std::make_unique<AssignmentQueue>(
+			[this](const AssignmentRequest& request) { return sendAssignment(request); });
+		occupancyStream_ = std::make_unique<OccupancyStream>(
+			[this](const std::string& event, const std::string& data) { onOccupancyStreamEvent(event, data); },
+			[this](bool connected) { onOccupancyStreamState(connected); });
+		standCatalogue_ = std::make_unique<StandCatalogueCache>(
+			[this](const std::string& path, const ApiClient::Headers& headers) { return getApiClient()->get(path, headers); });
+		engine_ = std::make_unique<StandStateEngine>(static_cast<EngineHost&>(*this), &metrics_);
+		if (const std::string directory = DiskCache::moduleDirectory(); !directory.empty()) {
+			diskCache_ = std::make_unique<DiskCache>((std::filesystem::path(directory) / DiskCache::FILE_NAME).string());
+		}
+
 		initialized_ = true;
 		isConnected_ = isConnected();
 		isController_ = isController();
@@ -66,8 +70,119 @@ void NeoRampAgent::Initialize(const PluginMetadata& metadata, CoreAPI* coreAPI,
 		logger_->error("Failed to initialize NeoRampAgent: " + std::string(e.what()));
 	}
 
-	this->m_stop = false;
-	this->m_worker = std::thread(&NeoRampAgent::run, this);
+	using std::chrono::milliseconds;
+	scheduler_ = std::make_unique<Scheduler>();
+	scheduler_->add("tick", TICK_INTERVAL, milliseconds(0), [this] { onTick(); });
+	scheduler_->add("occupancy", PollInterval::DEFAULT_BASE, milliseconds(2000), [this] { onOccupancyPoll(); });
+	scheduler_->add("catalogues", CATALOGUE_REFRESH_INTERVAL, milliseconds(5000), [this] { prefetchStandCatalogues(); });
+	scheduler_->add("suggestions", SUGGESTION_REFRESH_INTERVAL, milliseconds(500), [this] { onSuggestionRefresh(); });
+	scheduler_->add("metrics", METRICS_FLUSH_INTERVAL, milliseconds(0), [this] { dumpMetrics(); });
+	scheduler_->add("disk cache", DISK_CACHE_SAVE_INTERVAL, milliseconds(5000), [this] { saveDiskCache(); });
+	scheduler_->start();
+
+	// Network work runs once the radar client got control back
+	if (initialized_) startStartupTasks(loadedAt);
+}
+
+void NeoRampAgent::startStartupTasks(StartupTasks::Clock::time_point loadedAt)
+{
+	startupTasks_ = std::make_unique<StartupTasks>(loadedAt);
+	startupTasks_->add("disk cache", [this] { return restoreFromDiskCache(); });
+#ifndef DEV
+	startupTasks_->add("version check", [this] { return checkForUpdate(); });
+#endif // !DEV
+	startupTasks_->add("stand catalogues", [this] { return warmUpStandCatalogues(); });
+	startupTasks_->add("occupancy", [this] { return fetchFirstOccupancy(); });
+
+	startupTasks_->start([this](const std::vector<StartupTasks::Result>& results, std::chrono::milliseconds timeToReady) {
+		metrics_.histogram(Metrics::Stage::TimeToReady).record(timeToReady);
+
+		std::string summary;
+		for (const StartupTasks::Result& result : results) {
+			if (!summary.empty()) summary += ", ";
+			summary += result.name + ": " + result.outcome + " (" + std::to_string(result.elapsed.count()) + " ms)";
+		}
+		logger_->info("NeoRampAgent ready in " + std::to_string(timeToReady.count()) + " ms - " + summary);
+		DisplayMessage("Ready in " + std::to_string(timeToReady.count()) + " ms (" + summary + ")", "");
+	});
+}
+
+std::string NeoRampAgent::checkForUpdate()
+{
+	std::pair<bool, std::string> updateAvailable = newVersionAvailable();
+	if (!updateAvailable.first) return "done";
+
+	DisplayMessage("A new version of NeoRampAgent is available: " + updateAvailable.second + " (current version: " + NEORAMPAGENT_VERSION + ")", "");
+	return updateAvailable.second + " available";
+}
+
+std::string NeoRampAgent::warmUpStandCatalogues()
+{
+	if (!startupTasks_->waitFor([this] { return isConnected_.load(); }, STARTUP_CONNECTION_WAIT)) return "not connected";
+	if (!showsStandMenu() || !standCatalogue_) return "not needed";
+
+	const std::set<std::string> airports = standMenuAirports();
+	for (const std::string& icao : airports) standCatalogue_->prefetch(icao);
+
+	size_t loaded = 0;
+	startupTasks_->waitFor([&] {
+		loaded = 0;
+		for (const auto& catalogue : standCatalogue_->loaded()) loaded += airports.count(catalogue->icao);
+		return loaded == airports.size();
+	}, STARTUP_LOAD_WAIT);
+
+	// The first click then finds its menu ready
+	prepareStandDropdowns();
+	return std::to_string(loaded) + "/" + std::to_string(airports.size()) + " loaded";
+}
+
+std::string NeoRampAgent::restoreFromDiskCache()
+{
+	if (!diskCache_ || !engine_ || !standCatalogue_) return "disabled";
+
+	std::string error;
+	std::optional<DiskCacheContents> contents = diskCache_->load(&error);
+	if (!contents) return error;
+
+	const size_t catalogues = contents->catalogues.size();
+	for (auto& catalogue : contents->catalogues) standCatalogue_->seed(std::move(catalogue));
+
+	// Tags show the previous session's stands as stale until the first poll answers
+	const auto age = std::chrono::duration_cast<std::chrono::minutes>(std::chrono::system_clock::now() - contents->savedAt);
+	std::string snapshot = "no snapshot";
+	if (contents->snapshot && age > MAX_RESTORED_AGE) snapshot = "snapshot too old";
+	else if (contents->snapshot) snapshot = engine_->restore(contents->snapshot) ? "snapshot restored" : "snapshot superseded";
+
+	prepareStandDropdowns();
+	return std::to_string(catalogues) + " catalogues, " + snapshot + ", saved " + std::to_string(age.count()) + " min ago";
+}
+
+void NeoRampAgent::saveDiskCache()
+{
+	if (!diskCache_ || !engine_) return;
+
+	// Nothing new since the restore, the file already holds it
+	std::shared_ptr<const OccupancySnapshot> snapshot = engine_->snapshot();
+	if (snapshot && snapshot->fromDisk) return;
+	diskCache_->save(catalogues(), std::move(snapshot));
+}
+
+std::string NeoRampAgent::fetchFirstOccupancy()
+{
+	if (!startupTasks_->waitFor([this] { return isConnected_.load(); }, STARTUP_CONNECTION_WAIT)) return "not connected";
+	if (!engine_) return "unavailable";
+
+	// Polled now rather than after the first period, a snapshot from the disk cache does not count
+	auto fresh = [this] {
+		std::shared_ptr<const OccupancySnapshot> snapshot = engine_->snapshot();
+		return snapshot && !snapshot->fromDisk;
+	};
+	if (!fresh() && scheduler_) scheduler_->trigger("occupancy");
+	if (!startupTasks_->waitFor(fresh, STARTUP_LOAD_WAIT)) return "no answer yet";
+
+	std::shared_ptr<const OccupancySnapshot> snapshot = engine_->snapshot();
+	if (!snapshot->received) return "server unreachable";
+	return std::to_string(snapshot->airports.size()) + " airports";
 }
 
 std::pair<bool, std::string> rampAgent::NeoRampAgent::newVersionAvailable()
@@ -80,6 +195,10 @@ std::pair<bool, std::string> rampAgent::NeoRampAgent::newVersionAvailable()
 	httplib::Headers headers = { {"User-Agent", "NeoRampAgentVersionChecker"} };
 	std::string apiEndpoint = "/repos/AlexisBalzano/NeoRampAgent/releases/latest";
 
+	// Unloading the plugin interrupts the request instead of waiting up to both timeouts
+	const StartupTasks::StopHook stopHook = startupTasks_ ? startupTasks_->onStop([&cli] { cli.stop(); }) : StartupTasks::StopHook();
+	if (startupTasks_ && !stopHook) return { false, "" };
+
 	auto res = cli.Get(apiEndpoint.c_str(), headers);
 	if (res && res->status == 200) {
 		try
@@ -120,9 +239,35 @@ void NeoRampAgent::Shutdown()
 	}
 
 
-	this->m_stop = true;
-	if (this->m_worker.joinable()) {
-		this->m_worker.join();
+	// Before the scheduler, startup tasks trigger its jobs. A version check still in flight is waited for.
+	if (startupTasks_) {
+		startupTasks_->stop();
+		startupTasks_.reset();
+	}
+
+	// Wakes the scheduler at once, only waits for a job already running
+	if (scheduler_) {
+		scheduler_->stop();
+		scheduler_.reset();
+	}
+
+	if (occupancyStream_) {
+		occupancyStream_->stop();
+		occupancyStream_.reset();
+	}
+	// Last state for the next start, written before the catalogues go away
+	if (diskCache_) {
+		saveDiskCache();
+		diskCache_->stop();
+		diskCache_.reset();
+	}
+	if (assignmentQueue_) {
+		assignmentQueue_->stop();
+		assignmentQueue_.reset();
+	}
+	if (standCatalogue_) {
+		standCatalogue_->stop();
+		standCatalogue_.reset();
 	}
 
 	this->unegisterCommand();
@@ -141,15 +286,6 @@ void NeoRampAgent::DisplayMessage(const std::string& message, const std::string&
 	chatAPI_->sendClientMessage(textMessage);
 }
 
-void NeoRampAgent::run() {
-	int counter = 0;
-	while (!this->m_stop) {
-		std::this_thread::sleep_for(std::chrono::seconds(1));
-		counter++;
-		OnTimer(counter);
-	}
-}
-
 std::string rampAgent::NeoRampAgent::toUpper(std::string str)
 {
 	std::transform(str.begin(), str.end(), str.begin(),
@@ -173,128 +309,222 @@ bool rampAgent::NeoRampAgent::isController()
 		return false;
 	}
 #ifdef DEV
-	callsign_ = connectionInfo->callsign;
+	setCallsign(connectionInfo->callsign);
 	return true;
 #endif // DEV
 
 	if (isConnected_) {
 		if (connectionInfo->facility >= Fsd::NetworkFacility::DEL) {
-			callsign_ = connectionInfo->callsign;
+			setCallsign(connectionInfo->callsign);
 			return true;
 		}
 	}
 	return false;
 }
 
-void rampAgent::NeoRampAgent::sortStandList(std::vector<Stand>& standList)
-{
-	std::sort(standList.begin(), standList.end(), [](const Stand& a, const Stand& b) {
-		auto key = [](const std::string& s) {
-			size_t i = 0, n = s.size();
-
-			// Trim leading spaces
-			while (i < n && std::isspace(static_cast<unsigned char>(s[i]))) ++i;
-
-			// Leading number
-			int num = 0;
-			bool hasNum = false;
-			while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) {
-				hasNum = true;
-				int digit = s[i] - '0';
-				if (num > (std::numeric_limits<int>::max() - digit) / 10) {
-					num = std::numeric_limits<int>::max(); // clamp on overflow
-				}
-				else {
-					num = num * 10 + digit;
-				}
-				++i;
-			}
-
-			// Immediate letter suffix (A, B, AB, ...)
-			std::string letters;
-			while (i < n && std::isalpha(static_cast<unsigned char>(s[i]))) {
-				letters.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(s[i]))));
-				++i;
-			}
-
-			// Remainder (for stable tie-breaking, case-insensitive)
-			std::string tailUpper;
-			tailUpper.reserve(n - i);
-			for (; i < n; ++i) {
-				unsigned char c = static_cast<unsigned char>(s[i]);
-				tailUpper.push_back(static_cast<char>(std::toupper(c)));
-			}
-
-			// Bare names (no numeric prefix) go to the end.
-			return std::tuple<int, std::string, std::string, std::string>(
-				hasNum ? num : std::numeric_limits<int>::max(), letters, tailUpper, s
-			);
-			};
+std::map<std::string, OccupancyResponse> rampAgent::NeoRampAgent::getAirportsOccupancy(const std::vector<std::string>& airports)
+{
+	std::map<std::string, OccupancyResponse> responses;
+	if (airports.empty()) return responses;
 
-		const auto [an, al, ar, as] = key(a.name);
-		const auto [bn, bl, br, bs] = key(b.name);
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+	std::shared_ptr<ApiClient> client = getApiClient();
+	const std::string callsign = this->callsign();
+	if (occupancyPollClient_.lock() != client || occupancyPollCallsign_ != callsign) {
+		// New server or position, start again from full documents
+		resetOccupancyPollState();
+		occupancyPollClient_ = client;
+		occupancyPollCallsign_ = callsign;
+	}
 
-		if (an != bn) return an < bn;
+	// Requests are built up front, the workers only wait on the network
+	struct Request {
+		std::string path;
+		ApiClient::Headers headers;
+		ApiResponse result;
+		bool sent = false;
+	};
+	std::vector<Request> requests(airports.size());
+	for (size_t i = 0; i < airports.size(); ++i) {
+		const std::string& icao = airports[i];
+		requests[i].headers = airportSubscription_.headers(icao);
+		requests[i].path = "/api/occupancy/?callsign=" + callsign + "&icao=" + icao;
+		if (const std::string version = airportSubscription_.version(icao); !version.empty()) requests[i].path += "&since=" + version;
+	}
 
-		// If numbers equal, empty suffix (e.g., "2") comes before non-empty (e.g., "2A")
-		if (al != bl) {
-			if (al.empty() != bl.empty()) return al.empty();
-			return al < bl; // case-insensitive compare via uppercased letters
+	// Airports are shared by a few pooled connections; once one cannot reach the server
+	// the round ends instead of timing out on every remaining airport
+	std::atomic<size_t> next{ 0 };
+	std::atomic<bool> transportFailed{ false };
+	auto work = [&] {
+		for (size_t i = next++; i < requests.size() && !transportFailed; i = next++) {
+			{
+				ScopedTimer timer(metrics_.histogram(Metrics::Stage::ApiRoundTrip));
+				requests[i].result = client->get(requests[i].path, requests[i].headers);
+			}
+			requests[i].sent = true;
+			if (requests[i].result.status == 0) transportFailed = true;
 		}
+	};
+	std::vector<std::thread> workers;
+	for (size_t i = 1; i < std::min(requests.size(), POLL_CONCURRENCY); ++i) workers.emplace_back(work);
+	work();
+	for (std::thread& worker : workers) worker.join();
+
+	bool reached = false;
+	for (size_t i = 0; i < airports.size(); ++i) {
+		const std::string& icao = airports[i];
+		OccupancyResponse& response = responses[icao];
+		if (!requests[i].sent) {
+			airportSubscription_.onFailure(icao); // not tried, backs off with the others
+			continue;
+		}
+		metrics_.increment(Metrics::Counter::Polls);
+		reached |= requests[i].result.status != 0;
+		response = readAirportOccupancy(icao, requests[i].result);
+	}
 
-		// Fallback to case-insensitive remainder, then original (stable) name
-		if (ar != br) return ar < br;
-		return as < bs;
-		});
+	// Only the server as a whole is reported in chat, an airport it cannot serve is logged once
+	if (reached && !serverReachable_) {
+		serverReachable_ = true;
+		DisplayMessage("Successfully reconnected to NeoRampAgent server.", "");
+		logger_->info("Successfully reconnected to NeoRampAgent server.");
+	}
+	else if (!reached && serverReachable_) {
+		serverReachable_ = false;
+		DisplayMessage("Failed to reach NeoRampAgent server, stands shown may be outdated.", "");
+		logger_->error("Failed to reach NeoRampAgent server.");
+	}
+#else
+	logger_->warning("OpenSSL not available; cannot retrieve assigned stands from NeoRampAgent server.");
+#endif // #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+	return responses;
 }
 
-nlohmann::ordered_json rampAgent::NeoRampAgent::getAllAssignedStands()
+OccupancyResponse rampAgent::NeoRampAgent::readAirportOccupancy(const std::string& icao, ApiResponse& res)
 {
-	nlohmann::ordered_json assignedStandsJson = nlohmann::ordered_json::object();
-	
-#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
-	httplib::SSLClient cli(apiUrl_, 443);
-	httplib::Headers headers = { {"User-Agent", "NeoRampAgent"} };
-
-	auto res = cli.Get("/api/occupancy/?callsign=" + callsign_, headers);
-
-	if (res && res->status >= 200 && res->status < 300) {
-		if (!printError) {
-			printError = true; // reset error printing flag on success
-			DisplayMessage("Successfully reconnected to NeoRampAgent server.", "");
-			logger_->info("Successfully reconnected to NeoRampAgent server.");
+	OccupancyResponse response;
+	std::string problem;
+
+	if (res.ok() || res.status == 304) {
+		const int inboundSoon = engine_ ? engine_->inboundWithin(INBOUND_SOON_KM, icao) : 0;
+		if (res.status == 304) {
+			metrics_.increment(Metrics::Counter::NotModified);
+			airportSubscription_.onNotModified(icao, inboundSoon);
+			response.kind = OccupancyResponse::Kind::NotModified;
 		}
-		try {
-			if (!res->body.empty()) return assignedStandsJson = nlohmann::ordered_json::parse(res->body);
+		else if (res.body.empty()) {
+			// An empty body counts as no data, like a failed request
+			problem = "empty answer";
 		}
-		catch (const std::exception& e) {
-			logger_->error("Failed to parse assigned stands data from NeoRampAgent server: " + std::string(e.what()));
-			return assignedStandsJson;
+		else {
+			bool parsed;
+			{
+				ScopedTimer timer(metrics_.histogram(Metrics::Stage::Parse));
+				parsed = parseOccupancy(res.body, response.document, &problem);
+			}
+			if (parsed) {
+				response.kind = response.document.delta ? OccupancyResponse::Kind::Delta : OccupancyResponse::Kind::Full;
+				// A server without ETag or deltas resends the same body, only its content says whether the field is busy
+				const bool changed = !engine_ || engine_->changesAirport(icao, response.document);
+				airportSubscription_.onModified(icao, res.header("ETag"), res.header("Last-Modified"), response.document.version,
+					changed, inboundSoon);
+			}
+			else {
+				problem = "unreadable answer: " + problem;
+				response = OccupancyResponse();
+			}
 		}
 	}
 	else {
-		if (printError) {
-			printError = false; // avoid spamming logs
-			DisplayMessage("Failed to retrieve assigned stands data from NeoRampAgent server. HTTP status: " + std::to_string(res ? res->status : 0), "");
-			logger_->error("Failed to retrieve assigned stands data from NeoRampAgent server. HTTP status: " + std::to_string(res ? res->status : 0));
-		}
-		return assignedStandsJson;
+		metrics_.increment(Metrics::Counter::PollFailures);
+		problem = "HTTP status: " + std::to_string(res.status);
 	}
-#else
-	logger_->warning("OpenSSL not available; cannot retrieve assigned stands from NeoRampAgent server.");
-#endif // #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
-	return assignedStandsJson;
+
+	if (problem.empty()) {
+		if (failingAirports_.erase(icao)) logger_->info("Stands data for " + icao + " received again from NeoRampAgent server.");
+		return response;
+	}
+
+	airportSubscription_.onFailure(icao); // backs off, next request asks for a full document
+	// Transport failures are reported for the whole server by the caller
+	if (res.status != 0 && failingAirports_.insert(icao).second) {
+		logger_->error("Failed to retrieve " + icao + " stands data from NeoRampAgent server, " + problem);
+	}
+	return response;
+}
+
+void rampAgent::NeoRampAgent::resetOccupancyPollState()
+{
+	airportSubscription_.resetAll();
+}
+
+std::string rampAgent::NeoRampAgent::ownAirport()
+{
+	// Field of the position callsign, e.g. LFPG_TWR
+	const std::string callsign = this->callsign();
+	const std::string prefix = callsign.substr(0, callsign.find('_'));
+	return prefix.size() == 4 ? toUpper(prefix) : std::string();
+}
+
+std::set<std::string> rampAgent::NeoRampAgent::relevantAirports()
+{
+	// Airports the position covers: its own field, followed even with nothing on scope,
+	// and loaded airports with traffic close by. Far away destinations are not polled.
+	std::set<std::string> airports = engine_ ? engine_->airportsWithTrafficWithin(INBOUND_SOON_KM) : std::set<std::string>{};
+	if (const std::string own = ownAirport(); !own.empty()) airports.insert(own);
+	return airports;
+}
+
+std::set<std::string> rampAgent::NeoRampAgent::standMenuAirports()
+{
+	std::set<std::string> airports;
+	if (const std::string own = ownAirport(); !own.empty()) airports.insert(own);
+	for (const auto& flightplan : flightplanAPI_->getAll()) {
+		if (!flightplan.destination.empty()) airports.insert(flightplan.destination);
+	}
+	return airports;
+}
+
+void rampAgent::NeoRampAgent::scheduleOccupancyPoll()
+{
+	// Wakes up for the airport due first, each airport keeps its own period
+	if (scheduler_) scheduler_->setInterval("occupancy", std::max(airportSubscription_.untilNext(), MIN_POLL_SPACING));
 }
 
 bool rampAgent::NeoRampAgent::changeApiUrl(const std::string& newUrl)
 {
-	apiUrl_ = newUrl;
+	// Requests in flight keep the previous client alive until they return
+	auto client = std::make_shared<ApiClient>(newUrl);
+	{
+		std::lock_guard<std::mutex> lock(apiClientMutex_);
+		apiClient_.swap(client);
+	}
+	if (standCatalogue_) standCatalogue_->clear(); // stands may differ on the new server
 	return true;
 }
 
+std::shared_ptr<ApiClient> rampAgent::NeoRampAgent::getApiClient() const
+{
+	std::lock_guard<std::mutex> lock(apiClientMutex_);
+	return apiClient_;
+}
+
+std::string rampAgent::NeoRampAgent::callsign() const
+{
+	std::lock_guard<std::mutex> lock(callsignMutex_);
+	return callsign_;
+}
+
+void rampAgent::NeoRampAgent::setCallsign(const std::string& callsign)
+{
+	std::lock_guard<std::mutex> lock(callsignMutex_);
+	callsign_ = callsign;
+}
+
 std::string rampAgent::NeoRampAgent::generateToken(const std::string& callsign)
 {
-	std::string s = AUTH_SECRET + callsign_;
+	std::string s = AUTH_SECRET + callsign;
 	unsigned char hash[SHA256_DIGEST_LENGTH];
 	SHA256(reinterpret_cast<const unsigned char*>(s.data()), s.size(), hash);
 	std::ostringstream oss;
@@ -305,91 +535,186 @@ std::string rampAgent::NeoRampAgent::generateToken(const std::string& callsign)
 	return oss.str();
 }	
 
-void NeoRampAgent::runScopeUpdate() {
-	std::lock_guard<std::mutex> lock(occupiedStandstMutex_);
+void rampAgent::NeoRampAgent::setMetricsDumpFile(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(metricsFileMutex_);
+	metricsDumpFile_ = path;
+}
+
+bool rampAgent::NeoRampAgent::dumpMetrics()
+{
+	std::lock_guard<std::mutex> lock(metricsFileMutex_);
+	if (metricsDumpFile_.empty()) return true;
+
+	std::ofstream file(metricsDumpFile_, std::ios::trunc);
+	if (!file) {
+		logger_->error("Failed to write metrics to " + metricsDumpFile_);
+		return false;
+	}
+	file << metrics_.report();
+	return static_cast<bool>(file);
+}
 
+void NeoRampAgent::runScopeUpdate() {
 	LOG_DEBUG(Logger::LogLevel::Info, "Running scope update for stand assignments.");
-	lastOccupiedStands_ = getAllAssignedStands();
-	LOG_DEBUG(Logger::LogLevel::Info, "Retrieved occupied stands data: " + lastOccupiedStands_.dump());
-
-	if (lastOccupiedStands_.empty()) {
-		if (printError) {
-			DisplayMessage("No occupied stands data received to update tags.", "");
-			logger_->log(Logger::LogLevel::Warning, "No occupied stands data received to update tags.");
-			printError = false; // avoid spamming logs
-		}
-		// Clear All Tag Items
-		for (const auto& [callsign, standName] : lastStandTagMap_) {
-			UpdateTagItems(callsign, WHITE, "");
+
+	// Follow the airports relevant to the position, the ones left behind leave the snapshot
+	const std::set<std::string> airports = relevantAirports();
+	if (airportSubscription_.update(airports) && engine_) engine_->retainAirports(airports);
+	prefetchStandCatalogues();
+
+	// Only airports whose own period elapsed are requested, a quiet field is not re-read with a busy one.
+	// Fetched and parsed without holding any lock, readers keep the previous snapshot meanwhile.
+	std::map<std::string, OccupancyResponse> responses = getAirportsOccupancy(airportSubscription_.due());
+
+	if (engine_) {
+		for (const std::string& icao : engine_->ingestAirports(std::move(responses))) {
+			// Nothing to apply the answer to, ask for a full document next time
+			airportSubscription_.reset(icao);
 		}
-		lastStandTagMap_.clear();
-		return;
 	}
 
-	std::map<std::string, std::string> standTagMap;
+	prepareStandDropdowns();
+	scheduleOccupancyPoll();
+	if (scheduler_) scheduler_->trigger("suggestions"); // rank against the new occupancy
+}
 
-	LOG_DEBUG(Logger::LogLevel::Info, "Processing assigned stands for tag updates.");
+std::string rampAgent::NeoRampAgent::describePollInterval() const
+{
+	return "Occupancy polls: " + airportSubscription_.describe() + ", bounds " +
+		std::to_string(airportSubscription_.minimum().count()) + "-" + std::to_string(airportSubscription_.maximum().count()) + "s";
+}
 
-	auto& assigned = lastOccupiedStands_["assignedStands"];
-	lastOccupiedStands_["assignedStands"].insert(
-		lastOccupiedStands_["assignedStands"].end(),
-		lastOccupiedStands_["occupiedStands"].begin(),
-		lastOccupiedStands_["occupiedStands"].end()
-	); // display tag item on occupied stands as well
+bool rampAgent::NeoRampAgent::setPollIntervalBounds(int minimumSeconds, int maximumSeconds)
+{
+	if (!airportSubscription_.setBounds(std::chrono::seconds(minimumSeconds), std::chrono::seconds(maximumSeconds))) return false;
+	scheduleOccupancyPoll();
+	return true;
+}
 
-	LOG_DEBUG(Logger::LogLevel::Info, "Combined assigned and occupied stands for processing.");
+void rampAgent::NeoRampAgent::onOccupancyStreamEvent(const std::string& event, const std::string& data)
+{
+	if (event != "occupancy" && event != "message") return;
 
-	try {
-		for (const auto& stand : assigned) {
-			if (!stand.is_object()) continue;
+	// Stream documents use the poll format: a full snapshot on connect, deltas afterwards
+	metrics_.increment(Metrics::Counter::StreamEvents);
 
-			// callsign
-			const auto csIt = stand.find("callsign");
-			if (csIt == stand.end() || !csIt->is_string()) continue;
-			const std::string callsign = csIt->get<std::string>();
+	OccupancyResponse response;
+	std::string error;
+	bool parsed;
+	{
+		ScopedTimer timer(metrics_.histogram(Metrics::Stage::Parse));
+		parsed = parseOccupancy(data, response.document, &error);
+	}
+	if (!parsed) {
+		logger_->error("Failed to parse occupancy stream event: " + error);
+		return;
+	}
+	response.kind = response.document.delta ? OccupancyResponse::Kind::Delta : OccupancyResponse::Kind::Full;
 
-			// aircraft must exist on scope
-			std::optional<Aircraft::Aircraft> acOpt = aircraftAPI_->getByCallsign(callsign);
-			if (!acOpt.has_value()) continue;
+	prefetchStandCatalogues();
+	if (!engine_ || !engine_->ingest(std::move(response))) {
+		logger_->warning("Occupancy stream delta received before any snapshot, waiting for the next poll.");
+		streamDropped_ = true;
+		return;
+	}
+	prepareStandDropdowns();
+	if (scheduler_) scheduler_->trigger("suggestions");
+}
 
-			// stand name
-			const auto nameIt = stand.find("name");
-			if (nameIt == stand.end() || !nameIt->is_string()) continue;
-			const std::string standName = nameIt->get<std::string>();
-			standTagMap[callsign] = standName;
+void rampAgent::NeoRampAgent::onOccupancyStreamState(bool connected)
+{
+	if (connected) {
+		logger_->info("Occupancy stream connected, polling suspended.");
+	}
+	else {
+		logger_->info("Occupancy stream disconnected, falling back to polling.");
+		streamDropped_ = true; // poll at the next tick
+	}
+}
 
-			// remark: accept string only; treat null/other as empty
-			std::string remark;
-			if (auto rIt = stand.find("remark"); rIt != stand.end() && rIt->is_string()) {
-				remark = rIt->get<std::string>();
-			}
-			else {
-				remark.clear();
-			}
+void rampAgent::NeoRampAgent::updateOccupancyStream()
+{
+	if (!occupancyStream_) return;
 
-			// Update only if changed or new
-			if (auto it = lastStandTagMap_.find(callsign);
-				it != lastStandTagMap_.end() && it->second == standName) {
-				UpdateTagItems(callsign, WHITE, standName, remark);
-			}
-			else {
-				UpdateTagItems(callsign, YELLOW, standName, remark);
-			}
-		}
+	const std::string callsign = this->callsign();
+	if (!isConnected_ || callsign.empty()) {
+		occupancyStream_->stop();
+		return;
+	}
+	occupancyStream_->start(getApiClient()->host(), "/api/occupancy/stream?callsign=" + callsign);
+}
+
+void rampAgent::NeoRampAgent::refreshTagsFromSnapshot()
+{
+	if (!engine_) return;
+
+	prefetchStandCatalogues();
+	engine_->refreshTags();
+}
+
+bool rampAgent::NeoRampAgent::isOnScope(const std::string& callsign) const
+{
+	return aircraftAPI_->getByCallsign(callsign).has_value();
+}
+
+void rampAgent::NeoRampAgent::callsignsOnScope(std::vector<std::string>& callsigns) const
+{
+	callsigns.clear();
+	for (const auto& aircraft : aircraftAPI_->getAll()) {
+		callsigns.push_back(aircraft.callsign);
 	}
-	catch (const std::exception& e) {
-		logger_->error(std::string("runScopeUpdate: failed to process assigned stands: ") + e.what());
+}
+
+std::string rampAgent::NeoRampAgent::destinationOf(const std::string& callsign) const
+{
+	std::optional<Flightplan::Flightplan> fpOpt = flightplanAPI_->getByCallsign(callsign);
+	return fpOpt.has_value() ? fpOpt->destination : std::string();
+}
+
+std::vector<EngineHost::Flight> rampAgent::NeoRampAgent::flights() const
+{
+	// One aircraft list per call instead of one lookup per flight plan
+	const std::vector<Aircraft::Aircraft> aircraft = aircraftAPI_->getAll();
+	std::unordered_map<std::string_view, const Aircraft::Aircraft*> aircraftByCallsign;
+	aircraftByCallsign.reserve(aircraft.size());
+	for (const auto& ac : aircraft) aircraftByCallsign.emplace(ac.callsign, &ac);
+
+	std::vector<Flight> flights;
+	for (const auto& flightplan : flightplanAPI_->getAll()) {
+		auto it = aircraftByCallsign.find(flightplan.callsign);
+		if (it == aircraftByCallsign.end()) continue;
+
+		const Aircraft::Aircraft& ac = *it->second;
+		flights.push_back({ flightplan.callsign, flightplan.origin, flightplan.destination, flightplan.acType,
+			ac.position.latitude, ac.position.longitude, static_cast<double>(ac.position.groundSpeed) });
 	}
+	return flights;
+}
 
-	// Clear tags for aircraft that are no longer assigned
-	for (const auto& [callsign, standName] : lastStandTagMap_) {
-		if (standTagMap.find(callsign) == standTagMap.end()) {
-			UpdateTagItems(callsign, WHITE, "");
-		}
+std::vector<AircraftPosition> rampAgent::NeoRampAgent::positions() const
+{
+	std::vector<AircraftPosition> positions;
+	for (const auto& aircraft : aircraftAPI_->getAll()) {
+		positions.push_back({ aircraft.callsign, aircraft.position.latitude, aircraft.position.longitude,
+			static_cast<double>(aircraft.position.groundSpeed) });
 	}
+	return positions;
+}
 
-	lastStandTagMap_ = standTagMap;
-	LOG_DEBUG(Logger::LogLevel::Info, "Scope update completed.");
+std::vector<std::shared_ptr<const StandCatalogue>> rampAgent::NeoRampAgent::catalogues() const
+{
+	return standCatalogue_ ? standCatalogue_->loaded() : std::vector<std::shared_ptr<const StandCatalogue>>{};
+}
+
+void rampAgent::NeoRampAgent::prefetchStandCatalogues()
+{
+	if (!standCatalogue_ || !showsStandMenu()) return;
+
+	// Known airports are a no-op, new destinations are loaded in the background
+	for (const std::string& icao : standMenuAirports()) {
+		standCatalogue_->prefetch(icao);
+	}
 }
 
 void rampAgent::NeoRampAgent::OnFsdConnectionStateChange(const Fsd::FsdConnectionStateChangeEvent* event)
@@ -397,10 +722,81 @@ void rampAgent::NeoRampAgent::OnFsdConnectionStateChange(const Fsd::FsdConnectio
 	// recheck connection status to determine if we can send reports
 	isConnected_ = isConnected();
 	isController_ = isController();
+
+	// Start or stop the stream and poll right away instead of on the next period
+	if (scheduler_) {
+		scheduler_->trigger("tick");
+		scheduler_->trigger("occupancy");
+	}
 }
 
-void NeoRampAgent::OnTimer(int Counter) {
-	if (Counter % 15 == 0 && isConnected_) this->runScopeUpdate();
+void rampAgent::NeoRampAgent::OnAircraftConnected(const Aircraft::AircraftConnectedEvent* event)
+{
+	if (!initialized_ || !event || !engine_) return;
+	applyKnownStand(event->callsign);
+}
+
+void rampAgent::NeoRampAgent::OnAircraftDisconnected(const Aircraft::AircraftDisconnectedEvent* event)
+{
+	if (!initialized_ || !event || !engine_) return;
+	engine_->onCallsignGone(event->callsign);
+}
+
+void rampAgent::NeoRampAgent::OnFlightplanUpdated(const Flightplan::FlightplanUpdatedEvent* event)
+{
+	if (!initialized_ || !event || !engine_) return;
+	applyKnownStand(event->callsign);
+}
+
+void NeoRampAgent::applyKnownStand(const std::string& callsign)
+{
+	// Only callsigns the last document named but the scope did not show yet
+	if (engine_->onCallsignAppeared(callsign)) {
+		metrics_.increment(Metrics::Counter::EventTags);
+		LOG_DEBUG(Logger::LogLevel::Info, "Stand tag set on appearance of " + callsign);
+	}
+}
+
+void NeoRampAgent::onTick() {
+	processAssignmentResults();
+	updateOccupancyStream();
+
+	if (!isConnected_) return;
+	// Positions move every tick, unlike the server view
+	const bool localOccupancyChanged = engine_ && engine_->updateLocalOccupancy();
+
+	if (streamDropped_.exchange(false)) {
+		// Stream state may be ahead of the poll state, restart from a full document
+		resetOccupancyPollState();
+		this->runScopeUpdate();
+	}
+	else if (localOccupancyChanged) {
+		// An aircraft parked on or left a stand, warnings do not wait for the next poll
+		this->refreshTagsFromSnapshot();
+	}
+
+	// Catalogues loaded and parked aircraft seen since, the menus are ready before the next click
+	prepareStandDropdowns();
+}
+
+void NeoRampAgent::onOccupancyPoll() {
+	if (!isConnected_) return;
+
+	// While streaming, changes arrive as events; only refresh tags for aircraft that appeared since
+	if (occupancyStream_ && occupancyStream_->connected()) {
+		this->refreshTagsFromSnapshot();
+		airportSubscription_.onStreaming();
+		scheduleOccupancyPoll();
+	}
+	else this->runScopeUpdate();
+}
+
+void NeoRampAgent::onSuggestionRefresh() {
+	if (!engine_ || !showsStandMenu()) return;
+
+	// New flights and occupancy changes reach the suggestions within one period
+	engine_->updateSuggestions(SUGGESTED_STANDS);
+	prepareSuggestedDropdowns(); // a click only publishes them
 }
 
 PluginSDK::PluginMetadata NeoRampAgent::GetMetadata() const
@@ -3,11 +3,29 @@
 #include <thread>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <chrono>
 #include <nlohmann/json.hpp>
 #include <map>
+#include <set>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "NeoRadarSDK/SDK.h"
 #include "core/NeoRampAgentCommandProvider.h"
+#include "core/ApiClient.h"
+#include "core/AssignmentQueue.h"
+#include "core/StandCatalogueCache.h"
+#include "core/OccupancyParser.h"
+#include "core/OccupancyStream.h"
+#include "core/Scheduler.h"
+#include "core/StartupTasks.h"
+#include "core/PollInterval.h"
+#include "core/AirportSubscription.h"
+#include "core/DiskCache.h"
+#include "core/Metrics.h"
+#include "core/StandStateEngine.h"
 
 constexpr const char* NEORAMPAGENT_VERSION = "v1.0.6";
 constexpr const char* RAMPAGENT_API = "rampagent.vatsim.fr";
@@ -16,20 +34,9 @@ using namespace PluginSDK;
 
 namespace rampAgent {
 
-    struct Stand {
-        std::string name;
-        std::string icao;
-        bool occupied = false;
-    };
-
-    typedef std::optional<std::array<unsigned int, 3>> Colour;
-    inline Colour YELLOW = std::array<unsigned int, 3>({ 255, 220, 3 });
-    inline Colour WHITE = std::array<unsigned int, 3>({ 255, 255, 255 });
-
-
     class NeoRampAgentCommandProvider;
 
-    class NeoRampAgent : public BasePlugin
+    class NeoRampAgent : public BasePlugin, private EngineHost
     {
     public:
         NeoRampAgent();
@@ -47,8 +54,11 @@ namespace rampAgent {
 		
         // Scope events
 		virtual void OnFsdConnectionStateChange(const Fsd::FsdConnectionStateChangeEvent* event) override;
-        void OnTimer(int Counter);
         virtual bool OnTagShowDropdown(const std::string& actionId, const std::string& callsign) override;
+        // Tags of callsigns the server already knows are set as soon as the client shows them
+        virtual void OnAircraftConnected(const Aircraft::AircraftConnectedEvent* event) override;
+        virtual void OnAircraftDisconnected(const Aircraft::AircraftDisconnectedEvent* event) override;
+        virtual void OnFlightplanUpdated(const Flightplan::FlightplanUpdatedEvent* event) override;
 
         // Command handling
         void TagProcessing(const std::string& callsign, const std::string& actionId, const std::string& userInput = "");
@@ -65,36 +75,106 @@ namespace rampAgent {
 		Package::PackageAPI* GetPackageAPI() const { return packageAPI_; }
 
     private:
+        // Scheduler jobs
+        static constexpr std::chrono::seconds TICK_INTERVAL{ 1 };
+        static constexpr std::chrono::seconds CATALOGUE_REFRESH_INTERVAL{ 60 };
+        static constexpr std::chrono::seconds METRICS_FLUSH_INTERVAL{ 60 };
+        static constexpr std::chrono::milliseconds DROPDOWN_FRAME_BUDGET{ 16 }; // one frame at 60 Hz
+        static constexpr std::chrono::seconds SUGGESTION_REFRESH_INTERVAL{ 5 };
+        static constexpr size_t SUGGESTED_STANDS = 5; // at the top of the stand menu
+        static constexpr std::chrono::milliseconds MIN_POLL_SPACING{ 1000 }; // between two occupancy wake-ups
+        static constexpr double INBOUND_SOON_KM = 60.0; // about ten minutes out on approach
+        static constexpr size_t POLL_CONCURRENCY = ApiClient::DEFAULT_POOL_SIZE - 1; // every connection background requests may hold
+        static constexpr std::chrono::seconds STARTUP_CONNECTION_WAIT{ 30 }; // startup tasks give up past this
+        static constexpr std::chrono::seconds STARTUP_LOAD_WAIT{ 10 };
+        static constexpr std::chrono::seconds DISK_CACHE_SAVE_INTERVAL{ 60 };
+        static constexpr std::chrono::hours MAX_RESTORED_AGE{ 2 }; // older snapshots are not shown, stands still are
+
+        void startStartupTasks(StartupTasks::Clock::time_point loadedAt);
+        std::string checkForUpdate();
+        std::string warmUpStandCatalogues();
+        std::string fetchFirstOccupancy();
+        std::string restoreFromDiskCache();
+        void saveDiskCache();
         void runScopeUpdate();
-        void run();
+        void prefetchStandCatalogues();
+        void resetOccupancyPollState();
+        std::string ownAirport();
+        // Airports whose occupancy is polled
+        std::set<std::string> relevantAirports();
+        // Airports whose stand list is kept loaded for the menu: the own field and every destination
+        std::set<std::string> standMenuAirports();
+        OccupancyResponse readAirportOccupancy(const std::string& icao, ApiResponse& res);
+        void scheduleOccupancyPoll();
+        void refreshTagsFromSnapshot();
+        void applyKnownStand(const std::string& callsign);
+        void updateOccupancyStream();
+        void onOccupancyStreamEvent(const std::string& event, const std::string& data);
+        void onOccupancyStreamState(bool connected);
+        void onTick();
+        void onOccupancyPoll();
+        void onSuggestionRefresh();
 		bool isConnected();
         bool isController();
-        void sortStandList(std::vector<Stand>& standList);
+        // Only controllers get the stand menu, and with it catalogues, suggestions and prepared menus
+        bool showsStandMenu() const { return isConnected_ && isController_; }
+        void setCallsign(const std::string& callsign);
+
+        // EngineHost, answered from the PluginSDK
+        bool isOnScope(const std::string& callsign) const override;
+        void callsignsOnScope(std::vector<std::string>& callsigns) const override;
+        std::string destinationOf(const std::string& callsign) const override;
+        std::vector<Flight> flights() const override;
+        std::vector<AircraftPosition> positions() const override;
+        std::vector<std::shared_ptr<const StandCatalogue>> catalogues() const override;
+        void pushTag(const TagRenderCache::Update& update) override;
 
     public:
 		std::string toUpper(std::string str);
-        nlohmann::ordered_json getAllAssignedStands();
+        std::map<std::string, OccupancyResponse> getAirportsOccupancy(const std::vector<std::string>& airports);
 		bool changeApiUrl(const std::string& newUrl);
+        std::shared_ptr<ApiClient> getApiClient() const;
+        std::string callsign() const; // copy, the host thread may change it meanwhile
         std::string generateToken(const std::string& callsign);
+        std::string describePollInterval() const;
+        bool setPollIntervalBounds(int minimumSeconds, int maximumSeconds);
+        std::string metricsReport() const { return metrics_.report(); }
+        void setMetricsDumpFile(const std::string& path);
+        bool dumpMetrics();
 
     public:
         // Command IDs
         std::string versionId_;
 		std::string urlId_;
+		std::string pollId_;
+		std::string statsId_;
 
     private:
         // Plugin state
         bool initialized_ = false;
-        std::thread m_worker;
-        bool isConnected_ = false;
-        bool m_stop;
-        bool printError = true;
-		nlohmann::ordered_json lastOccupiedStands_;
-		std::mutex occupiedStandstMutex_;
-		std::map<std::string, std::string> lastStandTagMap_; // maps callsign to stand tag ID
-		std::string apiUrl_ = RAMPAGENT_API;
-        std::string callsign_;
-		bool isController_ = false;
+        std::unique_ptr<Scheduler> scheduler_;
+        std::unique_ptr<StartupTasks> startupTasks_; // network work deferred from Initialize()
+        std::atomic<bool> isConnected_{ false };
+        bool serverReachable_ = true; // chat reports changes only, touched by the poller
+        std::set<std::string> failingAirports_; // logged once until they answer again, touched by the poller
+		std::unique_ptr<StandStateEngine> engine_; // snapshots, local occupancy and tag state
+		std::unique_ptr<AssignmentQueue> assignmentQueue_;
+		std::unique_ptr<StandCatalogueCache> standCatalogue_;
+		std::unique_ptr<OccupancyStream> occupancyStream_;
+		std::unique_ptr<DiskCache> diskCache_; // warm start, null when the plugin directory is unknown
+		std::atomic<bool> streamDropped_{ false };
+		std::shared_ptr<ApiClient> apiClient_ = std::make_shared<ApiClient>(RAMPAGENT_API);
+		mutable std::mutex apiClientMutex_; // guards the apiClient_ pointer swap on url change
+		// Conditional and delta polling state, only touched by the poller
+		std::weak_ptr<ApiClient> occupancyPollClient_;
+		std::string occupancyPollCallsign_;
+		AirportSubscription airportSubscription_; // per-airport validators and poll schedule
+		Metrics metrics_;
+		std::string metricsDumpFile_; // empty when not dumping, guarded by metricsFileMutex_
+		std::mutex metricsFileMutex_;
+        std::string callsign_; // written by the host thread, read by jobs and workers through callsign()
+        mutable std::mutex callsignMutex_;
+		std::atomic<bool> isController_{ false };
 
         // APIs
         PluginMetadata metadata_;
@@ -117,13 +197,36 @@ namespace rampAgent {
         void unegisterCommand();
         void OnTagAction(const Tag::TagActionEvent* event) override;
         void OnTagDropdownAction(const Tag::DropdownActionEvent* event) override;
-        void UpdateTagItems(std::string Callsign, Colour colour = WHITE, std::string standName = "", std::string remark = "");
-        void updateStandMenuButtons(const std::string& icao, const nlohmann::ordered_json& occupiedStands);
+        // Stand menu, prepared per destination so a click only publishes it
+        struct PreparedDropdown {
+            std::shared_ptr<const StandCatalogue> catalogue; // inputs it was built from
+            std::shared_ptr<const OccupancySnapshot> snapshot;
+            std::shared_ptr<const LocalOccupancyView> localOccupancy;
+            PluginSDK::Tag::DropdownDefinition definition;
+            std::unordered_set<std::string> available; // stand names listed
+        };
+        // A flight's menu with its suggestions on top, prepared by the suggestions job
+        struct SuggestedDropdown {
+            std::shared_ptr<const PreparedDropdown> base; // menu the suggestions were checked against
+            std::vector<std::string> suggested;
+            PluginSDK::Tag::DropdownDefinition definition;
+        };
+        PluginSDK::Tag::DropdownDefinition buildStandDropdown(const std::shared_ptr<const StandCatalogue>& catalogue,
+            const OccupancySnapshot& occupancy, const std::shared_ptr<const LocalOccupancyView>& localOccupancy,
+            std::unordered_set<std::string>* available = nullptr);
+        std::shared_ptr<const PreparedDropdown> prepareStandDropdown(const std::string& icao, bool* built = nullptr);
+        void prepareStandDropdowns();
+        void prepareSuggestedDropdowns();
+        AssignmentResult sendAssignment(const AssignmentRequest& request);
+        void processAssignmentResults();
 
 	    // TAG Items IDs
 		std::string standTagId_;
 		std::string remarkTagId_;
         std::string standMenuId_;
+        std::map<std::string, std::shared_ptr<const PreparedDropdown>> preparedDropdowns_; // by destination ICAO
+        std::unordered_map<std::string, std::shared_ptr<const SuggestedDropdown>> suggestedDropdowns_; // by callsign
+        std::mutex dropdownMutex_; // guards both maps only, definitions are built outside it
 
         // TAG Action IDs
     };
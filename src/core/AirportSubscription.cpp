@@ -0,0 +1,205 @@
+#include "core/AirportSubscription.h"
+
+#include <algorithm>
+
+namespace rampAgent {
+
+bool AirportSubscription::update(const std::set<std::string>& airports, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool changed = false;
+
+    for (auto it = airports_.begin(); it != airports_.end();) {
+        if (airports.count(it->first)) {
+            ++it;
+            continue;
+        }
+        it = airports_.erase(it);
+        changed = true;
+    }
+
+    for (const std::string& icao : airports) {
+        if (icao.empty()) continue;
+        auto [it, inserted] = airports_.try_emplace(icao);
+        if (!inserted) continue;
+
+        it->second.interval.setBounds(minimum_, maximum_);
+        it->second.nextPoll = now;
+        changed = true;
+    }
+    return changed;
+}
+
+std::set<std::string> AirportSubscription::airports() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::set<std::string> airports;
+    for (const auto& [icao, state] : airports_) airports.insert(icao);
+    return airports;
+}
+
+std::vector<std::string> AirportSubscription::due(Clock::time_point now) const
+{
+    std::vector<std::pair<Clock::time_point, std::string>> due;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [icao, state] : airports_) {
+            if (state.nextPoll <= now) due.emplace_back(state.nextPoll, icao);
+        }
+    }
+    std::sort(due.begin(), due.end());
+
+    std::vector<std::string> airports;
+    airports.reserve(due.size());
+    for (auto& [nextPoll, icao] : due) airports.push_back(std::move(icao));
+    return airports;
+}
+
+std::chrono::milliseconds AirportSubscription::untilNext(Clock::time_point now) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (airports_.empty()) return maximum_;
+
+    Clock::time_point next = Clock::time_point::max();
+    for (const auto& [icao, state] : airports_) next = std::min(next, state.nextPoll);
+    if (next <= now) return std::chrono::milliseconds(0);
+    return std::chrono::ceil<std::chrono::milliseconds>(next - now);
+}
+
+ApiClient::Headers AirportSubscription::headers(const std::string& icao) const
+{
+    ApiClient::Headers headers;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = airports_.find(icao);
+    if (it == airports_.end()) return headers;
+
+    if (!it->second.etag.empty()) headers.emplace("If-None-Match", it->second.etag);
+    if (!it->second.lastModified.empty()) headers.emplace("If-Modified-Since", it->second.lastModified);
+    return headers;
+}
+
+std::string AirportSubscription::version(const std::string& icao) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = airports_.find(icao);
+    return it == airports_.end() ? std::string() : it->second.version;
+}
+
+void AirportSubscription::onModified(const std::string& icao, const std::string& etag, const std::string& lastModified,
+    const std::string& version, bool changed, int inboundSoon, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = airports_.find(icao);
+    if (it == airports_.end()) return; // dropped while the request was in flight
+
+    it->second.etag = etag;
+    it->second.lastModified = lastModified;
+    it->second.version = version;
+    it->second.interval.onSuccess(changed, inboundSoon);
+    scheduleLocked(it->second, now);
+}
+
+void AirportSubscription::onNotModified(const std::string& icao, int inboundSoon, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = airports_.find(icao);
+    if (it == airports_.end()) return;
+
+    it->second.interval.onSuccess(false, inboundSoon);
+    scheduleLocked(it->second, now);
+}
+
+void AirportSubscription::onFailure(const std::string& icao, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = airports_.find(icao);
+    if (it == airports_.end()) return;
+
+    // Next request asks for a full document
+    it->second.etag.clear();
+    it->second.lastModified.clear();
+    it->second.version.clear();
+    it->second.interval.onFailure();
+    scheduleLocked(it->second, now);
+}
+
+void AirportSubscription::onStreaming(Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [icao, state] : airports_) {
+        state.interval.onStreaming();
+        scheduleLocked(state, now);
+    }
+}
+
+void AirportSubscription::reset(const std::string& icao)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = airports_.find(icao);
+    if (it == airports_.end()) return;
+
+    it->second.etag.clear();
+    it->second.lastModified.clear();
+    it->second.version.clear();
+    it->second.nextPoll = Clock::now();
+}
+
+void AirportSubscription::resetAll()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Clock::time_point now = Clock::now();
+    for (auto& [icao, state] : airports_) {
+        state.etag.clear();
+        state.lastModified.clear();
+        state.version.clear();
+        state.nextPoll = now;
+    }
+}
+
+bool AirportSubscription::setBounds(PollInterval::Duration minimum, PollInterval::Duration maximum)
+{
+    if (minimum <= PollInterval::Duration::zero() || minimum > maximum) return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    minimum_ = minimum;
+    maximum_ = maximum;
+    const Clock::time_point now = Clock::now();
+    for (auto& [icao, state] : airports_) {
+        state.interval.setBounds(minimum, maximum);
+        // A shorter maximum takes effect now rather than after the current wait
+        state.nextPoll = std::min(state.nextPoll, now + state.interval.current());
+    }
+    return true;
+}
+
+PollInterval::Duration AirportSubscription::minimum() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return minimum_;
+}
+
+PollInterval::Duration AirportSubscription::maximum() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return maximum_;
+}
+
+std::string AirportSubscription::describe() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (airports_.empty()) return "no airport followed";
+
+    std::string out;
+    for (const auto& [icao, state] : airports_) {
+        if (!out.empty()) out += "; ";
+        out += icao + " every " + std::to_string(state.interval.current().count()) + "s (" + state.interval.reason() + ")";
+    }
+    return out;
+}
+
+void AirportSubscription::scheduleLocked(AirportState& state, Clock::time_point now)
+{
+    state.nextPoll = now + state.interval.current();
+}
+
+} // namespace rampAgent
@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "core/ApiClient.h"
+#include "core/PollInterval.h"
+
+namespace rampAgent {
+
+// Airports whose occupancy the position follows, each polled on its own schedule.
+// Every airport keeps its own conditional request state (ETag, Last-Modified,
+// version) and its own adaptive interval, so a busy hub is refreshed often
+// while a quiet satellite field backs off without being re-read.
+class AirportSubscription {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Replaces the followed airports; new ones are due at once. Returns true when the set changed.
+    bool update(const std::set<std::string>& airports, Clock::time_point now = Clock::now());
+    std::set<std::string> airports() const;
+
+    // Airports whose next poll is due, most overdue first
+    std::vector<std::string> due(Clock::time_point now = Clock::now()) const;
+    // Time until the next airport is due, zero when one already is, maximum() when none is followed
+    std::chrono::milliseconds untilNext(Clock::time_point now = Clock::now()) const;
+
+    // Conditional headers and the since= version for the next request of an airport
+    ApiClient::Headers headers(const std::string& icao) const;
+    std::string version(const std::string& icao) const;
+
+    // Schedules the next poll of an airport from the outcome of the current one
+    void onModified(const std::string& icao, const std::string& etag, const std::string& lastModified,
+        const std::string& version, bool changed, int inboundSoon, Clock::time_point now = Clock::now());
+    void onNotModified(const std::string& icao, int inboundSoon, Clock::time_point now = Clock::now());
+    void onFailure(const std::string& icao, Clock::time_point now = Clock::now());
+    // While the stream delivers every airport, polls only refresh tags
+    void onStreaming(Clock::time_point now = Clock::now());
+
+    // Next request of the airport (or of every airport) asks for a full document, right away
+    void reset(const std::string& icao);
+    void resetAll();
+
+    // Bounds applied to every airport's interval, current and future
+    bool setBounds(PollInterval::Duration minimum, PollInterval::Duration maximum);
+    PollInterval::Duration minimum() const;
+    PollInterval::Duration maximum() const;
+
+    // One line per airport: interval and why it was chosen
+    std::string describe() const;
+
+private:
+    struct AirportState {
+        std::string etag;
+        std::string lastModified;
+        std::string version;
+        PollInterval interval;
+        Clock::time_point nextPoll;
+    };
+
+    void scheduleLocked(AirportState& state, Clock::time_point now);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, AirportState> airports_;
+    PollInterval::Duration minimum_ = PollInterval::DEFAULT_MINIMUM;
+    PollInterval::Duration maximum_ = PollInterval::DEFAULT_MAXIMUM;
+};
+
+} // namespace rampAgent
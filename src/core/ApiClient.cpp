@@ -0,0 +1,107 @@
+#include "core/ApiClient.h"
+
+#include <algorithm>
+#include <cctype>
+#include <httplib.h>
+
+namespace rampAgent {
+
+struct ApiClient::Connection {
+    std::unique_ptr<httplib::Client> client;
+};
+
+namespace {
+std::string toLower(std::string str)
+{
+    std::transform(str.begin(), str.end(), str.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return str;
+}
+} // namespace
+
+std::string ApiResponse::header(const std::string& key) const
+{
+    auto it = headers.find(toLower(key));
+    return it != headers.end() ? it->second : std::string();
+}
+
+ApiClient::ApiClient(std::string url, size_t poolSize)
+    : host_(std::move(url)), baseUrl_(schemeHostPort(host_)), poolSize_(poolSize == 0 ? 1 : poolSize),
+      backgroundLimit_(poolSize_ > 1 ? poolSize_ - 1 : 1)
+{
+}
+
+ApiClient::~ApiClient() = default;
+
+std::string ApiClient::schemeHostPort(const std::string& url)
+{
+    std::string base = url.find("://") == std::string::npos ? "https://" + url : url;
+    while (!base.empty() && base.back() == '/') base.pop_back();
+    return base;
+}
+
+std::unique_ptr<ApiClient::Connection> ApiClient::connect() const
+{
+    auto connection = std::make_unique<Connection>();
+    connection->client = std::make_unique<httplib::Client>(baseUrl_);
+    connection->client->set_keep_alive(true);
+    connection->client->set_connection_timeout(CONNECTION_TIMEOUT_S);
+    connection->client->set_read_timeout(READ_TIMEOUT_S);
+    connection->client->set_write_timeout(WRITE_TIMEOUT_S);
+    connection->client->set_default_headers({ {"User-Agent", "NeoRampAgent"} });
+    return connection;
+}
+
+std::unique_ptr<ApiClient::Connection> ApiClient::acquire(Priority priority)
+{
+    std::unique_lock<std::mutex> lock(poolMutex_);
+    poolCv_.wait(lock, [this, priority] {
+        if (priority == Priority::Background && backgroundLeased_ >= backgroundLimit_) return false;
+        return !idle_.empty() || leased_ < poolSize_;
+    });
+
+    ++leased_;
+    if (priority == Priority::Background) ++backgroundLeased_;
+    if (!idle_.empty()) {
+        auto connection = std::move(idle_.back());
+        idle_.pop_back();
+        return connection;
+    }
+
+    lock.unlock();
+    return connect(); // socket is opened lazily by the first request
+}
+
+void ApiClient::release(std::unique_ptr<Connection> connection, Priority priority, bool reusable)
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        --leased_;
+        if (priority == Priority::Background) --backgroundLeased_;
+        if (reusable) idle_.push_back(std::move(connection));
+    }
+    poolCv_.notify_all(); // waiters of either priority may be able to go
+}
+
+ApiResponse ApiClient::get(const std::string& path, const Headers& headers, Priority priority)
+{
+    ApiResponse response;
+
+    auto connection = acquire(priority);
+    auto res = connection->client->Get(path, httplib::Headers(headers.begin(), headers.end()));
+
+    // A failed transport leaves the socket in an unknown state, reconnect next time
+    const bool reusable = static_cast<bool>(res);
+    if (res) {
+        response.status = res->status;
+        response.body = std::move(res->body);
+        for (const auto& [key, value] : res->headers) {
+            response.headers.emplace(toLower(key), value);
+        }
+    }
+    release(std::move(connection), priority, reusable);
+
+    return response;
+}
+
+} // namespace rampAgent
@@ -0,0 +1,72 @@
+#pragma once
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rampAgent {
+
+struct ApiResponse {
+    int status = 0; // 0 when the request never reached the server
+    std::string body;
+    std::multimap<std::string, std::string> headers; // keys lower-cased
+
+    bool ok() const { return status >= 200 && status < 300; }
+    std::string header(const std::string& key) const;
+};
+
+// Long-lived HTTPS connections to one Ramp Agent host.
+// A small pool of keep-alive clients is shared by the poller and UI-triggered
+// requests so the TCP/TLS handshake is paid once per connection, not per call.
+// Background requests leave the last connection of the pool to interactive ones.
+// Changing the API url means building a new ApiClient; in-flight requests keep
+// the old one alive until they complete.
+class ApiClient {
+public:
+    using Headers = std::multimap<std::string, std::string>;
+
+    enum class Priority {
+        Background,  // polls and catalogue loads
+        Interactive, // a controller is waiting on it, e.g. a stand assignment
+    };
+
+    static constexpr size_t DEFAULT_POOL_SIZE = 3;
+    static constexpr int CONNECTION_TIMEOUT_S = 3;
+    static constexpr int READ_TIMEOUT_S = 5;
+    static constexpr int WRITE_TIMEOUT_S = 5;
+
+    // url is a bare host name (HTTPS on 443) or a full scheme://host[:port], e.g. a local http stub
+    explicit ApiClient(std::string url, size_t poolSize = DEFAULT_POOL_SIZE);
+    ~ApiClient();
+
+    ApiClient(const ApiClient&) = delete;
+    ApiClient& operator=(const ApiClient&) = delete;
+
+    ApiResponse get(const std::string& path, const Headers& headers = {}, Priority priority = Priority::Background);
+
+    const std::string& host() const { return host_; }
+
+    static std::string schemeHostPort(const std::string& url);
+
+private:
+    struct Connection;
+
+    std::unique_ptr<Connection> acquire(Priority priority);
+    void release(std::unique_ptr<Connection> connection, Priority priority, bool reusable);
+    std::unique_ptr<Connection> connect() const;
+
+    const std::string host_;
+    const std::string baseUrl_;
+    const size_t poolSize_;
+
+    std::mutex poolMutex_;
+    std::condition_variable poolCv_;
+    std::vector<std::unique_ptr<Connection>> idle_;
+    size_t leased_ = 0;
+    size_t backgroundLeased_ = 0; // kept below backgroundLimit_
+    const size_t backgroundLimit_;
+};
+
+} // namespace rampAgent
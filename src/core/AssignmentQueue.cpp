@@ -0,0 +1,82 @@
+#include "core/AssignmentQueue.h"
+
+namespace rampAgent {
+
+AssignmentQueue::AssignmentQueue(Sender sender)
+    : sender_(std::move(sender))
+{
+    worker_ = std::thread(&AssignmentQueue::run, this);
+}
+
+AssignmentQueue::~AssignmentQueue()
+{
+    stop();
+}
+
+uint64_t AssignmentQueue::submit(AssignmentRequest request)
+{
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sequence = nextSequence_++;
+        request.sequence = sequence;
+
+        // Merge with an unsent request for the same callsign, keeping its queue position
+        auto it = queued_.find(request.callsign);
+        if (it != queued_.end()) {
+            it->second = std::move(request);
+        }
+        else {
+            order_.push_back(request.callsign);
+            queued_.emplace(request.callsign, std::move(request));
+        }
+    }
+    cv_.notify_one();
+    return sequence;
+}
+
+std::vector<AssignmentResult> AssignmentQueue::drainCompleted()
+{
+    std::vector<AssignmentResult> results;
+    std::lock_guard<std::mutex> lock(completedMutex_);
+    results.swap(completed_);
+    return results;
+}
+
+void AssignmentQueue::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void AssignmentQueue::run()
+{
+    while (true) {
+        AssignmentRequest request;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !order_.empty(); });
+            if (stop_) return;
+
+            std::string callsign = std::move(order_.front());
+            order_.pop_front();
+            auto it = queued_.find(callsign);
+            request = std::move(it->second);
+            queued_.erase(it);
+        }
+
+        AssignmentResult result = sender_(request);
+        result.request = std::move(request);
+
+        std::lock_guard<std::mutex> lock(completedMutex_);
+        completed_.push_back(std::move(result));
+    }
+}
+
+} // namespace rampAgent
@@ -0,0 +1,70 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace rampAgent {
+
+struct AssignmentRequest {
+    std::string callsign;
+    std::string standName; // "None" frees the current assignment
+    std::string icao;
+    uint64_t sequence = 0;
+};
+
+enum class AssignmentOutcome {
+    Assigned,
+    Freed,
+    Rejected, // server answered but refused the stand
+    Failed    // transport error or malformed answer
+};
+
+struct AssignmentResult {
+    AssignmentRequest request;
+    AssignmentOutcome outcome = AssignmentOutcome::Failed;
+    std::string message;
+};
+
+// Sends manual stand assignments on a background executor.
+// Requests for a callsign that has not been sent yet are merged, so only the
+// latest click goes to the server. Results are collected on a completion queue
+// drained by the plugin worker, which owns every tag update.
+class AssignmentQueue {
+public:
+    using Sender = std::function<AssignmentResult(const AssignmentRequest&)>;
+
+    explicit AssignmentQueue(Sender sender);
+    ~AssignmentQueue();
+
+    AssignmentQueue(const AssignmentQueue&) = delete;
+    AssignmentQueue& operator=(const AssignmentQueue&) = delete;
+
+    // Returns the sequence number given to the request
+    uint64_t submit(AssignmentRequest request);
+    std::vector<AssignmentResult> drainCompleted();
+    void stop();
+
+private:
+    void run();
+
+    Sender sender_;
+    std::thread worker_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    uint64_t nextSequence_ = 1;
+    std::unordered_map<std::string, AssignmentRequest> queued_; // latest unsent request per callsign
+    std::deque<std::string> order_; // callsigns in submission order
+
+    std::mutex completedMutex_;
+    std::vector<AssignmentResult> completed_;
+};
+
+} // namespace rampAgent
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <sstream>
 #include <string>
 
 #include "NeoRampAgent.h"
@@ -29,6 +30,35 @@ void NeoRampAgent::RegisterCommand() {
 		definition.parameters.push_back(url);
 
         urlId_ = chatAPI_->registerCommand(definition.name, definition, CommandProvider_);
+
+        definition.name = "rampAgent poll";
+        definition.description = "Display occupancy poll intervals per airport, or set their bounds in seconds";
+        definition.lastParameterHasSpaces = false;
+        definition.parameters.clear();
+        PluginSDK::Chat::CommandParameter minimum;
+        minimum.name = "min";
+        minimum.type = PluginSDK::Chat::ParameterType::Number;
+        minimum.required = false;
+        definition.parameters.push_back(minimum);
+        PluginSDK::Chat::CommandParameter maximum;
+        maximum.name = "max";
+        maximum.type = PluginSDK::Chat::ParameterType::Number;
+        maximum.required = false;
+        definition.parameters.push_back(maximum);
+
+        pollId_ = chatAPI_->registerCommand(definition.name, definition, CommandProvider_);
+
+        definition.name = "rampAgent stats";
+        definition.description = "Display timings and counters, optionally dump them to a file every minute (off to stop)";
+        definition.lastParameterHasSpaces = true;
+        definition.parameters.clear();
+        PluginSDK::Chat::CommandParameter file;
+        file.name = "file";
+        file.type = PluginSDK::Chat::ParameterType::String;
+        file.required = false;
+        definition.parameters.push_back(file);
+
+        statsId_ = chatAPI_->registerCommand(definition.name, definition, CommandProvider_);
         
         definition.name = "rampAgent menu";
         definition.description = "Display select stand menu ICAO";
@@ -47,6 +77,8 @@ inline void NeoRampAgent::unegisterCommand()
     {
         chatAPI_->unregisterCommand(versionId_);
         chatAPI_->unregisterCommand(urlId_);
+        chatAPI_->unregisterCommand(pollId_);
+        chatAPI_->unregisterCommand(statsId_);
         CommandProvider_.reset();
 	}
 }
@@ -64,6 +96,48 @@ Chat::CommandResult NeoRampAgentCommandProvider::Execute( const std::string &com
         neoRampAgent_->DisplayMessage("API URL changed to: " + args[0], "");
 		return { true, std::nullopt };
     }
+    else if (commandId == neoRampAgent_->pollId_)
+    {
+        if (args.size() >= 2) {
+            int minimum = 0, maximum = 0;
+            try {
+                minimum = std::stoi(args[0]);
+                maximum = std::stoi(args[1]);
+            }
+            catch (const std::exception&) {
+                return { false, std::string("Poll bounds must be numbers of seconds") };
+            }
+            if (!neoRampAgent_->setPollIntervalBounds(minimum, maximum)) {
+                return { false, std::string("Invalid poll bounds, expected 0 < min <= max") };
+            }
+        }
+        neoRampAgent_->DisplayMessage(neoRampAgent_->describePollInterval(), "");
+        return { true, std::nullopt };
+    }
+    else if (commandId == neoRampAgent_->statsId_)
+    {
+        if (!args.empty() && !args[0].empty()) {
+            if (args[0] == "off") {
+                neoRampAgent_->setMetricsDumpFile("");
+                neoRampAgent_->DisplayMessage("Stopped dumping metrics", "");
+            }
+            else {
+                neoRampAgent_->setMetricsDumpFile(args[0]);
+                if (!neoRampAgent_->dumpMetrics()) {
+                    neoRampAgent_->setMetricsDumpFile("");
+                    return { false, "Cannot write metrics to " + args[0] };
+                }
+                neoRampAgent_->DisplayMessage("Dumping metrics to " + args[0] + " every minute", "");
+            }
+        }
+
+        // One chat line per report line
+        std::istringstream report(neoRampAgent_->metricsReport());
+        for (std::string line; std::getline(report, line);) {
+            neoRampAgent_->DisplayMessage(line, "");
+        }
+        return { true, std::nullopt };
+    }
     else {
 		std::string error = "Unknown command ID: " + commandId;
         return { false, error };
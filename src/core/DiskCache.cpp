@@ -0,0 +1,509 @@
+#include "core/DiskCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rampAgent {
+
+namespace {
+
+// On-disk layout, native little-endian: header, catalogues, stands, airports, entries, strings.
+// Every record is a multiple of 8 bytes so each section stays aligned inside the mapping.
+constexpr char MAGIC[8] = { 'N', 'R', 'A', 'C', 'A', 'C', 'H', 'E' };
+
+struct StringRef {
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t catalogueCount;
+    uint32_t standCount;
+    uint32_t airportCount;
+    uint32_t entryCount;
+    uint32_t hasSnapshot;
+    int64_t savedAtMs;          // system clock, ms since the epoch
+    uint64_t fileSize;
+    uint64_t stringsSize;
+    uint64_t checksum;          // FNV-1a of everything after the header
+};
+
+struct CatalogueRecord {
+    StringRef icao;
+    StringRef etag;
+    uint32_t firstStand;
+    uint32_t standCount;
+};
+
+struct StandRecord {
+    StringRef name;
+    StringRef icao;
+    StringRef sortTail;
+    StringRef operators;        // comma separated
+    uint64_t sortSuffix;
+    double latitude;
+    double longitude;
+    double radius;
+    int32_t sortNumber;
+    int32_t priority;
+    uint8_t codes;
+    int8_t schengen;
+    uint8_t hasPosition;
+    uint8_t occupied;
+    uint32_t reserved;
+};
+
+struct AirportRecord {
+    StringRef icao;
+    StringRef version;
+    uint32_t firstEntry;
+    uint32_t entryCount;
+    uint32_t received;
+    uint32_t reserved;
+    int64_t fetchedAtMs;        // system clock, ms since the epoch
+};
+
+struct EntryRecord {
+    StringRef callsign;
+    StringRef stand;
+    StringRef remark;
+    StringRef icao;
+    uint8_t kind;
+    uint8_t reserved[7];
+};
+
+static_assert(sizeof(FileHeader) == 64 && sizeof(CatalogueRecord) == 24 && sizeof(StandRecord) == 80 &&
+    sizeof(AirportRecord) == 40 && sizeof(EntryRecord) == 40, "disk cache records changed size, bump FORMAT_VERSION");
+static_assert(std::is_trivially_copyable_v<StandRecord> && std::is_trivially_copyable_v<EntryRecord>);
+
+uint64_t fnv1a(const uint8_t* data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+int64_t toMs(std::chrono::system_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+// The same instant on the steady clock, for ages computed by the engine
+std::chrono::steady_clock::time_point toSteady(int64_t ms)
+{
+    const auto age = std::chrono::system_clock::now() - std::chrono::system_clock::time_point(std::chrono::milliseconds(ms));
+    return std::chrono::steady_clock::now() - std::chrono::duration_cast<std::chrono::steady_clock::duration>(age);
+}
+
+class StringTable {
+public:
+    StringRef add(const std::string& text)
+    {
+        StringRef ref{ static_cast<uint32_t>(blob_.size()), static_cast<uint32_t>(text.size()) };
+        blob_ += text;
+        return ref;
+    }
+    const std::string& blob() const { return blob_; }
+
+private:
+    std::string blob_;
+};
+
+// Read-only view of a whole file, unmapped on destruction
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path)
+    {
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) return;
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_) return;
+        data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (data_) size_ = static_cast<size_t>(size.QuadPart);
+#else
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) return;
+        struct stat info;
+        if (::fstat(fd_, &info) != 0 || info.st_size == 0) return;
+        void* data = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (data == MAP_FAILED) return;
+        data_ = static_cast<const uint8_t*>(data);
+        size_ = static_cast<size_t>(info.st_size);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace
+
+DiskCache::DiskCache(std::string path)
+    : path_(std::move(path))
+{
+    worker_ = std::thread(&DiskCache::run, this);
+}
+
+DiskCache::~DiskCache()
+{
+    stop();
+}
+
+std::optional<DiskCacheContents> DiskCache::load(std::string* error) const
+{
+    return read(path_, error);
+}
+
+void DiskCache::save(std::vector<std::shared_ptr<const StandCatalogue>> catalogues, std::shared_ptr<const OccupancySnapshot> snapshot)
+{
+    std::vector<std::pair<std::string, uint64_t>> revisions;
+    revisions.reserve(catalogues.size());
+    for (const auto& catalogue : catalogues) revisions.emplace_back(catalogue->icao, catalogue->revision);
+    std::sort(revisions.begin(), revisions.end());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_ || (snapshot == savedSnapshot_ && revisions == savedRevisions_)) return;
+        savedSnapshot_ = snapshot;
+        savedRevisions_ = std::move(revisions);
+        pending_ = Pending{ std::move(catalogues), std::move(snapshot) };
+    }
+    cv_.notify_one();
+}
+
+void DiskCache::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void DiskCache::run()
+{
+    while (true) {
+        Pending pending;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || pending_.has_value(); });
+            // The last state is still written on the way out
+            if (!pending_) return;
+            pending = std::move(*pending_);
+            pending_.reset();
+        }
+        write(path_, pending.catalogues, pending.snapshot.get());
+    }
+}
+
+bool DiskCache::write(const std::string& path, const std::vector<std::shared_ptr<const StandCatalogue>>& catalogues,
+    const OccupancySnapshot* snapshot, std::string* error)
+{
+    StringTable strings;
+    std::vector<CatalogueRecord> catalogueRecords;
+    std::vector<StandRecord> standRecords;
+    std::vector<AirportRecord> airportRecords;
+    std::vector<EntryRecord> entryRecords;
+
+    for (const auto& catalogue : catalogues) {
+        CatalogueRecord& record = catalogueRecords.emplace_back();
+        record.icao = strings.add(catalogue->icao);
+        record.etag = strings.add(catalogue->etag);
+        record.firstStand = static_cast<uint32_t>(standRecords.size());
+        record.standCount = static_cast<uint32_t>(catalogue->stands.size());
+
+        for (const Stand& stand : catalogue->stands) {
+            std::string operators;
+            for (const std::string& op : stand.operators) {
+                if (!operators.empty()) operators += ',';
+                operators += op;
+            }
+
+            StandRecord& standRecord = standRecords.emplace_back();
+            std::memset(&standRecord, 0, sizeof(standRecord));
+            standRecord.name = strings.add(stand.name);
+            standRecord.icao = strings.add(stand.icao);
+            standRecord.sortTail = strings.add(stand.sortKey.tail);
+            standRecord.operators = strings.add(operators);
+            standRecord.sortSuffix = stand.sortKey.suffix;
+            standRecord.latitude = stand.latitude;
+            standRecord.longitude = stand.longitude;
+            standRecord.radius = stand.radius;
+            standRecord.sortNumber = stand.sortKey.number;
+            standRecord.priority = stand.priority;
+            standRecord.codes = stand.codes;
+            standRecord.schengen = stand.schengen;
+            standRecord.hasPosition = stand.hasPosition;
+            standRecord.occupied = stand.occupied;
+        }
+    }
+
+    const auto now = std::chrono::system_clock::now();
+    if (snapshot) {
+        const auto steadyNow = std::chrono::steady_clock::now();
+        for (const auto& [icao, airport] : snapshot->airports) {
+            AirportRecord& record = airportRecords.emplace_back();
+            std::memset(&record, 0, sizeof(record));
+            record.icao = strings.add(airport->icao);
+            record.version = strings.add(airport->version);
+            record.firstEntry = static_cast<uint32_t>(entryRecords.size());
+            record.entryCount = static_cast<uint32_t>(airport->entries.size());
+            record.received = airport->received;
+            record.fetchedAtMs = toMs(now - std::chrono::duration_cast<std::chrono::system_clock::duration>(steadyNow - airport->fetchedAt));
+
+            for (const OccupancyEntry& entry : airport->entries) {
+                EntryRecord& entryRecord = entryRecords.emplace_back();
+                std::memset(&entryRecord, 0, sizeof(entryRecord));
+                entryRecord.callsign = strings.add(entry.callsign);
+                entryRecord.stand = strings.add(entry.stand);
+                entryRecord.remark = strings.add(entry.remark);
+                entryRecord.icao = strings.add(entry.icao);
+                entryRecord.kind = static_cast<uint8_t>(entry.kind);
+            }
+        }
+    }
+
+    // Payload first so the header can carry its checksum
+    std::string payload;
+    auto append = [&payload](const auto& records) {
+        payload.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(records[0]));
+    };
+    append(catalogueRecords);
+    append(standRecords);
+    append(airportRecords);
+    append(entryRecords);
+    payload += strings.blob();
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.formatVersion = FORMAT_VERSION;
+    header.catalogueCount = static_cast<uint32_t>(catalogueRecords.size());
+    header.standCount = static_cast<uint32_t>(standRecords.size());
+    header.airportCount = static_cast<uint32_t>(airportRecords.size());
+    header.entryCount = static_cast<uint32_t>(entryRecords.size());
+    header.hasSnapshot = snapshot != nullptr;
+    header.savedAtMs = toMs(now);
+    header.fileSize = sizeof(header) + payload.size();
+    header.stringsSize = strings.blob().size();
+    header.checksum = fnv1a(reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+
+    // Readers only ever see the previous file or the complete new one
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        file.close();
+        if (!file) {
+            if (error) *error = "cannot write " + temporary;
+            std::error_code ignored;
+            std::filesystem::remove(temporary, ignored);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temporary, path, ec);
+    if (ec) {
+        if (error) *error = "cannot replace " + path + ": " + ec.message();
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
+
+std::optional<DiskCacheContents> DiskCache::read(const std::string& path, std::string* error)
+{
+    auto fail = [error](const std::string& reason) -> std::optional<DiskCacheContents> {
+        if (error) *error = reason;
+        return std::nullopt;
+    };
+
+    MappedFile file(path);
+    if (!file.data()) return fail("no cache file");
+    if (file.size() < sizeof(FileHeader)) return fail("truncated header");
+
+    const auto* header = reinterpret_cast<const FileHeader*>(file.data());
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) return fail("not a cache file");
+    if (header->formatVersion != FORMAT_VERSION) return fail("format version " + std::to_string(header->formatVersion));
+
+    const uint64_t catalogueBytes = uint64_t{ header->catalogueCount } * sizeof(CatalogueRecord);
+    const uint64_t standBytes = uint64_t{ header->standCount } * sizeof(StandRecord);
+    const uint64_t airportBytes = uint64_t{ header->airportCount } * sizeof(AirportRecord);
+    const uint64_t entryBytes = uint64_t{ header->entryCount } * sizeof(EntryRecord);
+    const uint64_t expected = sizeof(FileHeader) + catalogueBytes + standBytes + airportBytes + entryBytes + header->stringsSize;
+    if (header->fileSize != file.size() || expected != file.size()) return fail("size mismatch");
+
+    const uint8_t* payload = file.data() + sizeof(FileHeader);
+    if (fnv1a(payload, file.size() - sizeof(FileHeader)) != header->checksum) return fail("checksum mismatch");
+
+    // Sections are read in place from the mapping
+    const auto* catalogues = reinterpret_cast<const CatalogueRecord*>(payload);
+    const auto* stands = reinterpret_cast<const StandRecord*>(payload + catalogueBytes);
+    const auto* airports = reinterpret_cast<const AirportRecord*>(payload + catalogueBytes + standBytes);
+    const auto* entries = reinterpret_cast<const EntryRecord*>(payload + catalogueBytes + standBytes + airportBytes);
+    const char* strings = reinterpret_cast<const char*>(payload + catalogueBytes + standBytes + airportBytes + entryBytes);
+
+    bool valid = true;
+    auto text = [&](StringRef ref) {
+        if (uint64_t{ ref.offset } + ref.size > header->stringsSize) {
+            valid = false;
+            return std::string();
+        }
+        return std::string(strings + ref.offset, ref.size);
+    };
+
+    DiskCacheContents contents;
+    contents.savedAt = std::chrono::system_clock::time_point(std::chrono::milliseconds(header->savedAtMs));
+
+    contents.catalogues.reserve(header->catalogueCount);
+    for (uint32_t c = 0; c < header->catalogueCount; ++c) {
+        const CatalogueRecord& record = catalogues[c];
+        if (uint64_t{ record.firstStand } + record.standCount > header->standCount) return fail("stand range out of bounds");
+
+        auto catalogue = std::make_shared<StandCatalogue>();
+        catalogue->icao = text(record.icao);
+        catalogue->etag = text(record.etag);
+        catalogue->stands.reserve(record.standCount);
+        // Stored in menu order with their keys, nothing to sort
+        for (uint32_t s = record.firstStand; s < record.firstStand + record.standCount; ++s) {
+            const StandRecord& standRecord = stands[s];
+            Stand& stand = catalogue->stands.emplace_back();
+            stand.name = text(standRecord.name);
+            stand.icao = text(standRecord.icao);
+            stand.occupied = standRecord.occupied != 0;
+            stand.sortKey.number = standRecord.sortNumber;
+            stand.sortKey.suffix = standRecord.sortSuffix;
+            stand.sortKey.tail = text(standRecord.sortTail);
+            stand.hasPosition = standRecord.hasPosition != 0;
+            stand.latitude = standRecord.latitude;
+            stand.longitude = standRecord.longitude;
+            stand.radius = standRecord.radius;
+            stand.codes = standRecord.codes;
+            stand.schengen = standRecord.schengen;
+            stand.priority = standRecord.priority;
+
+            const std::string operators = text(standRecord.operators);
+            for (size_t start = 0; start < operators.size();) {
+                const size_t end = std::min(operators.find(',', start), operators.size());
+                stand.operators.push_back(operators.substr(start, end - start));
+                start = end + 1;
+            }
+        }
+        contents.catalogues.push_back(std::move(catalogue));
+    }
+
+    if (header->hasSnapshot) {
+        auto snapshot = std::make_shared<OccupancySnapshot>();
+        for (uint32_t a = 0; a < header->airportCount; ++a) {
+            const AirportRecord& record = airports[a];
+            if (uint64_t{ record.firstEntry } + record.entryCount > header->entryCount) return fail("entry range out of bounds");
+
+            auto airport = std::make_shared<AirportOccupancy>();
+            airport->icao = text(record.icao);
+            airport->version = text(record.version);
+            airport->received = record.received != 0;
+            airport->restored = true;
+            airport->fetchedAt = toSteady(record.fetchedAtMs);
+            airport->entries.reserve(record.entryCount);
+            for (uint32_t e = record.firstEntry; e < record.firstEntry + record.entryCount; ++e) {
+                const EntryRecord& entryRecord = entries[e];
+                if (entryRecord.kind > static_cast<uint8_t>(OccupancyKind::Blocked)) return fail("unknown entry kind");
+
+                OccupancyEntry& entry = airport->entries.emplace_back();
+                entry.callsign = text(entryRecord.callsign);
+                entry.stand = text(entryRecord.stand);
+                entry.remark = text(entryRecord.remark);
+                entry.icao = text(entryRecord.icao);
+                entry.kind = static_cast<OccupancyKind>(entryRecord.kind);
+            }
+            StandStateEngine::buildIndex(*airport);
+            snapshot->received |= airport->received;
+            snapshot->airports[airport->icao] = std::move(airport);
+        }
+        snapshot->fromDisk = true;
+        snapshot->fetchedAt = toSteady(header->savedAtMs);
+        contents.snapshot = std::move(snapshot);
+    }
+
+    if (!valid) return fail("string out of bounds");
+    return contents;
+}
+
+std::string DiskCache::moduleDirectory()
+{
+#ifdef _WIN32
+    HMODULE module = nullptr;
+    if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+            reinterpret_cast<LPCSTR>(&DiskCache::moduleDirectory), &module)) {
+        return std::string();
+    }
+    char buffer[MAX_PATH];
+    const DWORD length = GetModuleFileNameA(module, buffer, MAX_PATH);
+    if (length == 0 || length == MAX_PATH) return std::string();
+    const std::filesystem::path file(std::string(buffer, length));
+#else
+    Dl_info info{};
+    if (!dladdr(reinterpret_cast<void*>(&DiskCache::moduleDirectory), &info) || !info.dli_fname) return std::string();
+    const std::filesystem::path file(info.dli_fname);
+#endif
+    return file.parent_path().string();
+}
+
+} // namespace rampAgent
@@ -0,0 +1,78 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/StandCatalogue.h"
+#include "core/StandStateEngine.h"
+
+namespace rampAgent {
+
+// What a previous session left on disk
+struct DiskCacheContents {
+    std::vector<std::shared_ptr<StandCatalogue>> catalogues; // in menu order, sort keys filled
+    std::shared_ptr<const OccupancySnapshot> snapshot;       // airports marked restored, null when none was saved
+    std::chrono::system_clock::time_point savedAt;
+};
+
+// Stand catalogues and the last occupancy snapshot kept in one binary file
+// next to the plugin, so a restart has stands and tags before its first poll.
+// The file is a header followed by fixed-size records and one string table;
+// it is memory-mapped and read in place, without any JSON or sorting, and
+// rewritten through a temporary file renamed over the previous one.
+class DiskCache {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1; // bump on any layout change, older files are ignored
+    static constexpr const char* FILE_NAME = "NeoRampAgentCache.bin";
+
+    explicit DiskCache(std::string path);
+    ~DiskCache();
+
+    DiskCache(const DiskCache&) = delete;
+    DiskCache& operator=(const DiskCache&) = delete;
+
+    const std::string& path() const { return path_; }
+
+    // Reads the file, nullopt when it is missing, from another format version or damaged
+    std::optional<DiskCacheContents> load(std::string* error = nullptr) const;
+
+    // Queues a background write, superseding one not started yet.
+    // Skipped when neither the snapshot nor any catalogue revision changed since the last write.
+    void save(std::vector<std::shared_ptr<const StandCatalogue>> catalogues, std::shared_ptr<const OccupancySnapshot> snapshot);
+    // Finishes a queued write, then joins the writer
+    void stop();
+
+    static bool write(const std::string& path, const std::vector<std::shared_ptr<const StandCatalogue>>& catalogues,
+        const OccupancySnapshot* snapshot, std::string* error = nullptr);
+    static std::optional<DiskCacheContents> read(const std::string& path, std::string* error = nullptr);
+
+    // Directory of the binary holding this code, i.e. the plugin, empty when unknown
+    static std::string moduleDirectory();
+
+private:
+    struct Pending {
+        std::vector<std::shared_ptr<const StandCatalogue>> catalogues;
+        std::shared_ptr<const OccupancySnapshot> snapshot;
+    };
+
+    void run();
+
+    const std::string path_;
+    std::thread worker_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::optional<Pending> pending_;
+    // What the last queued write held, to skip identical ones
+    std::shared_ptr<const OccupancySnapshot> savedSnapshot_;
+    std::vector<std::pair<std::string, uint64_t>> savedRevisions_;
+};
+
+} // namespace rampAgent
@@ -0,0 +1,125 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace rampAgent {
+
+// Open-addressing hash map from a 32-bit id (see StringInterner) to a value.
+// Linear probing over one contiguous slot array, erase by backward shift so no
+// tombstones pile up. clear() and erase() keep the capacity, so a map refilled
+// with the same keys every cycle does not allocate once it has grown.
+template <typename V>
+class FlatIdMap {
+public:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    V* find(uint32_t key)
+    {
+        if (size_ == 0) return nullptr;
+        for (size_t i = home(key);; i = next(i)) {
+            if (slots_[i].key == key) return &slots_[i].value;
+            if (slots_[i].key == EMPTY) return nullptr;
+        }
+    }
+
+    const V* find(uint32_t key) const { return const_cast<FlatIdMap*>(this)->find(key); }
+    bool contains(uint32_t key) const { return find(key) != nullptr; }
+
+    // Value of key, default-constructed when it was not there
+    V& operator[](uint32_t key)
+    {
+        if ((size_ + 1) * 4 > slots_.size() * 3) grow();
+        size_t i = home(key);
+        for (; slots_[i].key != EMPTY; i = next(i)) {
+            if (slots_[i].key == key) return slots_[i].value;
+        }
+        slots_[i].key = key;
+        slots_[i].value = V();
+        ++size_;
+        return slots_[i].value;
+    }
+
+    bool erase(uint32_t key)
+    {
+        if (size_ == 0) return false;
+        size_t hole = home(key);
+        for (; slots_[hole].key != key; hole = next(hole)) {
+            if (slots_[hole].key == EMPTY) return false;
+        }
+
+        // Pull back every later entry of the run that may sit in the hole
+        for (size_t i = next(hole); slots_[i].key != EMPTY; i = next(i)) {
+            const size_t wanted = home(slots_[i].key);
+            const bool movable = hole <= i ? (wanted <= hole || wanted > i) : (wanted <= hole && wanted > i);
+            if (!movable) continue;
+            slots_[hole].key = slots_[i].key;
+            slots_[hole].value = std::move(slots_[i].value);
+            hole = i;
+        }
+        slots_[hole].key = EMPTY;
+        --size_;
+        return true;
+    }
+
+    // Calls fn(key, value) for every entry, in slot order. fn must not insert or erase.
+    template <typename Fn>
+    void forEach(Fn&& fn)
+    {
+        for (Slot& slot : slots_) {
+            if (slot.key != EMPTY) fn(slot.key, slot.value);
+        }
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const
+    {
+        for (const Slot& slot : slots_) {
+            if (slot.key != EMPTY) fn(slot.key, slot.value);
+        }
+    }
+
+    void clear()
+    {
+        for (Slot& slot : slots_) slot.key = EMPTY;
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    struct Slot {
+        uint32_t key = EMPTY;
+        V value{};
+    };
+
+    // Fibonacci hashing spreads the dense, sequential ids of the interner
+    size_t home(uint32_t key) const { return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_); }
+    size_t next(size_t i) const { return (i + 1) & (slots_.size() - 1); }
+
+    void grow()
+    {
+        std::vector<Slot> previous = std::move(slots_);
+        const size_t capacity = previous.empty() ? 16 : previous.size() * 2;
+        slots_.assign(capacity, Slot{});
+        shift_ = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) --shift_;
+        size_ = 0;
+        for (Slot& slot : previous) {
+            if (slot.key == EMPTY) continue;
+            size_t i = home(slot.key);
+            while (slots_[i].key != EMPTY) i = next(i);
+            slots_[i].key = slot.key;
+            slots_[i].value = std::move(slot.value);
+            ++size_;
+        }
+    }
+
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+    unsigned shift_ = 64;
+};
+
+} // namespace rampAgent
@@ -0,0 +1,135 @@
+#include "core/LocalOccupancy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace rampAgent {
+
+namespace {
+constexpr double METRES_PER_DEG_LAT = 110540.0;
+constexpr double METRES_PER_DEG_LON_EQUATOR = 111320.0;
+constexpr double PI = 3.14159265358979323846;
+}
+
+void LocalOccupancyEngine::syncCatalogues(const std::vector<std::shared_ptr<const StandCatalogue>>& catalogues)
+{
+    std::unordered_set<std::string> seen;
+    for (const auto& catalogue : catalogues) {
+        if (!catalogue) continue;
+        seen.insert(catalogue->icao);
+
+        AirportGrid& grid = airports_[catalogue->icao];
+        if (!grid.catalogue || grid.catalogue->revision != catalogue->revision) {
+            grid.build(catalogue);
+        }
+        else {
+            grid.catalogue = catalogue; // revalidated copy, same stands
+        }
+    }
+
+    // Airports without positioned stands are kept too, so they are not rebuilt on every call
+    for (auto it = airports_.begin(); it != airports_.end();) {
+        if (seen.count(it->first) == 0) it = airports_.erase(it);
+        else ++it;
+    }
+}
+
+std::shared_ptr<const LocalOccupancyView> LocalOccupancyEngine::detect(const std::vector<AircraftPosition>& aircraft) const
+{
+    auto view = std::make_shared<LocalOccupancyView>();
+
+    for (const AircraftPosition& position : aircraft) {
+        if (position.groundSpeed > PARKED_SPEED_KTS) continue;
+
+        for (const auto& [icao, grid] : airports_) {
+            if (const Stand* stand = grid.match(position.latitude, position.longitude)) {
+                view->occupants[icao][stand->name].push_back(position.callsign);
+                break;
+            }
+        }
+    }
+
+    // Independent of the order aircraft are listed in, for comparisons between ticks
+    for (auto& [icao, stands] : view->occupants) {
+        for (auto& [standName, callsigns] : stands) {
+            if (callsigns.size() > 1) std::sort(callsigns.begin(), callsigns.end());
+        }
+    }
+    return view;
+}
+
+void LocalOccupancyEngine::AirportGrid::build(std::shared_ptr<const StandCatalogue> source)
+{
+    catalogue = std::move(source);
+    cells.clear();
+
+    const std::vector<Stand>& stands = catalogue->stands;
+    bool hasOrigin = false;
+    for (const Stand& stand : stands) {
+        if (!stand.hasPosition) continue;
+        if (!hasOrigin) {
+            originLat = stand.latitude;
+            originLon = stand.longitude;
+            metresPerDegLon = METRES_PER_DEG_LON_EQUATOR * std::cos(originLat * PI / 180.0);
+            minX = maxX = minY = maxY = 0.0;
+            hasOrigin = true;
+        }
+
+        const double radius = stand.radius > 0.0 ? stand.radius : DEFAULT_STAND_RADIUS_M;
+        double x, y;
+        toMetres(stand.latitude, stand.longitude, x, y);
+        minX = std::min(minX, x - radius);
+        maxX = std::max(maxX, x + radius);
+        minY = std::min(minY, y - radius);
+        maxY = std::max(maxY, y + radius);
+
+        const auto index = static_cast<uint32_t>(&stand - stands.data());
+        const int64_t cx0 = static_cast<int64_t>(std::floor((x - radius) / CELL_SIZE_M));
+        const int64_t cx1 = static_cast<int64_t>(std::floor((x + radius) / CELL_SIZE_M));
+        const int64_t cy0 = static_cast<int64_t>(std::floor((y - radius) / CELL_SIZE_M));
+        const int64_t cy1 = static_cast<int64_t>(std::floor((y + radius) / CELL_SIZE_M));
+        for (int64_t cx = cx0; cx <= cx1; ++cx) {
+            for (int64_t cy = cy0; cy <= cy1; ++cy) {
+                cells[cellKey(cx, cy)].push_back(index);
+            }
+        }
+    }
+}
+
+void LocalOccupancyEngine::AirportGrid::toMetres(double lat, double lon, double& x, double& y) const
+{
+    x = (lon - originLon) * metresPerDegLon;
+    y = (lat - originLat) * METRES_PER_DEG_LAT;
+}
+
+const Stand* LocalOccupancyEngine::AirportGrid::match(double lat, double lon) const
+{
+    if (cells.empty()) return nullptr;
+
+    double x, y;
+    toMetres(lat, lon, x, y);
+    if (x < minX || x > maxX || y < minY || y > maxY) return nullptr;
+
+    auto cellIt = cells.find(cellKey(static_cast<int64_t>(std::floor(x / CELL_SIZE_M)),
+                                     static_cast<int64_t>(std::floor(y / CELL_SIZE_M))));
+    if (cellIt == cells.end()) return nullptr;
+
+    // Closest stand relative to its size wins when circles overlap
+    const Stand* best = nullptr;
+    double bestRatio = 1.0;
+    for (uint32_t index : cellIt->second) {
+        const Stand& stand = catalogue->stands[index];
+        const double radius = stand.radius > 0.0 ? stand.radius : DEFAULT_STAND_RADIUS_M;
+        double sx, sy;
+        toMetres(stand.latitude, stand.longitude, sx, sy);
+        const double ratio = std::hypot(x - sx, y - sy) / radius;
+        if (ratio <= bestRatio) {
+            bestRatio = ratio;
+            best = &stand;
+        }
+    }
+    return best;
+}
+
+} // namespace rampAgent
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/StandCatalogue.h"
+
+namespace rampAgent {
+
+struct AircraftPosition {
+    std::string callsign;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double groundSpeed = 0.0; // knots
+};
+
+// Stands found occupied from aircraft positions, independent of the server view
+struct LocalOccupancyView {
+    // icao -> stand name -> callsigns parked on it, sorted
+    std::unordered_map<std::string, std::unordered_map<std::string, std::vector<std::string>>> occupants;
+
+    // nullptr when the stand is free
+    const std::vector<std::string>* occupantsOf(const std::string& icao, const std::string& standName) const
+    {
+        auto airportIt = occupants.find(icao);
+        if (airportIt == occupants.end()) return nullptr;
+        auto standIt = airportIt->second.find(standName);
+        return standIt != airportIt->second.end() ? &standIt->second : nullptr;
+    }
+
+    bool isOccupied(const std::string& icao, const std::string& standName) const { return occupantsOf(icao, standName) != nullptr; }
+
+    // Any aircraft but callsign parked on the stand
+    bool isOccupiedByOther(const std::string& icao, const std::string& standName, const std::string& callsign) const
+    {
+        const std::vector<std::string>* parked = occupantsOf(icao, standName);
+        if (!parked) return false;
+        for (const std::string& occupant : *parked) {
+            if (occupant != callsign) return true;
+        }
+        return false;
+    }
+
+    bool operator==(const LocalOccupancyView& other) const { return occupants == other.occupants; }
+};
+
+// Matches stationary aircraft to stand circles through a per-airport uniform grid.
+// Each stand is registered in every cell its circle overlaps, so a position
+// only looks at its own cell.
+class LocalOccupancyEngine {
+public:
+    static constexpr double CELL_SIZE_M = 100.0;
+    static constexpr double DEFAULT_STAND_RADIUS_M = 25.0; // stands published without a radius
+    static constexpr double PARKED_SPEED_KTS = 2.0;
+
+    // Rebuilds the grid of airports whose catalogue changed, drops the ones no longer loaded
+    void syncCatalogues(const std::vector<std::shared_ptr<const StandCatalogue>>& catalogues);
+    std::shared_ptr<const LocalOccupancyView> detect(const std::vector<AircraftPosition>& aircraft) const;
+
+    // No loaded airport has a positioned stand, positions are not worth reading
+    bool empty() const
+    {
+        for (const auto& [icao, grid] : airports_) {
+            if (!grid.cells.empty()) return false;
+        }
+        return true;
+    }
+
+private:
+    struct AirportGrid {
+        std::shared_ptr<const StandCatalogue> catalogue;
+        double originLat = 0.0;
+        double originLon = 0.0;
+        double metresPerDegLon = 0.0;
+        double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0; // bounding box in metres from origin
+        std::unordered_map<int64_t, std::vector<uint32_t>> cells; // indices into catalogue->stands, empty without positions
+
+        void build(std::shared_ptr<const StandCatalogue> source);
+        void toMetres(double lat, double lon, double& x, double& y) const;
+        const Stand* match(double lat, double lon) const;
+    };
+
+    static int64_t cellKey(int64_t cx, int64_t cy) { return (cx << 32) ^ (cy & 0xffffffff); }
+
+    std::unordered_map<std::string, AirportGrid> airports_;
+};
+
+} // namespace rampAgent
@@ -0,0 +1,99 @@
+#include "core/Metrics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+
+namespace rampAgent {
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration)
+{
+    const uint64_t us = static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+    const size_t bucket = std::min<size_t>(static_cast<size_t>(std::bit_width(us)), BUCKETS - 1);
+
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    totalUs_.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t previous = maxUs_.load(std::memory_order_relaxed);
+    while (us > previous && !maxUs_.compare_exchange_weak(previous, us, std::memory_order_relaxed)) {
+    }
+}
+
+std::chrono::microseconds LatencyHistogram::quantile(double q) const
+{
+    const uint64_t samples = count();
+    if (samples == 0) return std::chrono::microseconds(0);
+
+    const uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(samples - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // Bucket bounds are powers of two, never report more than the largest sample
+            return std::min(std::chrono::microseconds(uint64_t{ 1 } << i), max());
+        }
+    }
+    return max();
+}
+
+const char* Metrics::name(Stage stage)
+{
+    switch (stage) {
+    case Stage::ApiRoundTrip: return "api round trip";
+    case Stage::Parse: return "parse";
+    case Stage::Ingest: return "ingest";
+    case Stage::TagLockWait: return "tag lock wait";
+    case Stage::TagApply: return "tag apply";
+    case Stage::TagPush: return "tag push";
+    case Stage::DropdownBuild: return "dropdown build";
+    case Stage::DropdownShow: return "dropdown show";
+    case Stage::TimeToReady: return "time to ready";
+    default: return "?";
+    }
+}
+
+const char* Metrics::name(Counter counter)
+{
+    switch (counter) {
+    case Counter::Polls: return "polls";
+    case Counter::PollFailures: return "poll failures";
+    case Counter::NotModified: return "not modified";
+    case Counter::StreamEvents: return "stream events";
+    case Counter::TagValuesSent: return "tag values sent";
+    case Counter::DropdownMisses: return "dropdown misses";
+    case Counter::EventTags: return "event tags";
+    default: return "?";
+    }
+}
+
+std::string Metrics::report() const
+{
+    const auto uptime = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - started_);
+    std::string out = "Uptime " + std::to_string(uptime.count()) + "s\n";
+
+    for (size_t i = 0; i < counters_.size(); ++i) {
+        if (i) out += ", ";
+        out += std::string(name(static_cast<Counter>(i))) + " " + std::to_string(counters_[i].load(std::memory_order_relaxed));
+    }
+    out += "\n";
+
+    char line[160];
+    for (size_t i = 0; i < histograms_.size(); ++i) {
+        const LatencyHistogram& histogram = histograms_[i];
+        const uint64_t samples = histogram.count();
+        if (samples == 0) continue;
+
+        std::snprintf(line, sizeof(line), "%-15s n=%llu avg=%lluus p50<=%lldus p99<=%lldus max=%lldus\n",
+            name(static_cast<Stage>(i)),
+            static_cast<unsigned long long>(samples),
+            static_cast<unsigned long long>(histogram.total().count() / static_cast<int64_t>(samples)),
+            static_cast<long long>(histogram.quantile(0.5).count()),
+            static_cast<long long>(histogram.quantile(0.99).count()),
+            static_cast<long long>(histogram.max().count()));
+        out += line;
+    }
+    return out;
+}
+
+} // namespace rampAgent
@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace rampAgent {
+
+// Latency distribution over fixed power-of-two buckets, from 1 us up to ~33 s.
+// record() is a handful of relaxed atomic increments, safe from any thread.
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKETS = 26; // bucket i holds samples below 2^i us, the last one the rest
+
+    void record(std::chrono::nanoseconds duration);
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    std::chrono::microseconds total() const { return std::chrono::microseconds(totalUs_.load(std::memory_order_relaxed)); }
+    std::chrono::microseconds max() const { return std::chrono::microseconds(maxUs_.load(std::memory_order_relaxed)); }
+    // Upper bound of the bucket holding the given quantile (0..1)
+    std::chrono::microseconds quantile(double q) const;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+    std::atomic<uint64_t> count_{ 0 };
+    std::atomic<uint64_t> totalUs_{ 0 };
+    std::atomic<uint64_t> maxUs_{ 0 };
+};
+
+// Hot-path timings and counters of the plugin, shown by .rampAgent stats
+class Metrics {
+public:
+    enum class Stage : uint8_t {
+        ApiRoundTrip,   // occupancy request, connection and transfer
+        Parse,          // occupancy document decoding
+        Ingest,         // delta merge, index and snapshot publication
+        TagLockWait,    // waiting for the engine tag state lock
+        TagApply,       // occupancy to tag values, lock held
+        TagPush,        // UpdateTagValue calls to the host
+        DropdownBuild,  // stand menu filtering and definition, mostly in the background
+        DropdownShow,   // click to stand menu published, must stay below one frame
+        TimeToReady,    // plugin load to every startup task done
+        Count
+    };
+
+    enum class Counter : uint8_t {
+        Polls,
+        PollFailures,
+        NotModified,
+        StreamEvents,
+        TagValuesSent,
+        DropdownMisses, // clicks that found no up-to-date prepared menu
+        EventTags,      // tags set when an aircraft or flight plan appeared, ahead of the next poll
+        Count
+    };
+
+    LatencyHistogram& histogram(Stage stage) { return histograms_[static_cast<size_t>(stage)]; }
+    void increment(Counter counter, uint64_t amount = 1)
+    {
+        counters_[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    // Multi-line summary, one line per stage with samples
+    std::string report() const;
+
+    static const char* name(Stage stage);
+    static const char* name(Counter counter);
+
+private:
+    std::array<LatencyHistogram, static_cast<size_t>(Stage::Count)> histograms_;
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::Count)> counters_{};
+    const std::chrono::steady_clock::time_point started_ = std::chrono::steady_clock::now();
+};
+
+// Records the lifetime of the scope into a histogram
+class ScopedTimer {
+public:
+    explicit ScopedTimer(LatencyHistogram& histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() { histogram_.record(std::chrono::steady_clock::now() - start_); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    LatencyHistogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace rampAgent
@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace rampAgent {
+
+// Stands that are assigned, occupied or blocked, hashed per ICAO.
+// Built once per occupancy poll so the stand menu filters in O(stands)
+// without copying any name out of the JSON document.
+class OccupancyIndex {
+public:
+    // icao may be empty when the server did not report it, such entries match every airport
+    void add(const std::string& icao, const std::string& standName)
+    {
+        if (standName.empty()) return;
+        byIcao_[icao].insert(standName);
+    }
+
+    bool contains(const std::string& icao, const std::string& standName) const
+    {
+        return containsIn(icao, standName) || (!icao.empty() && containsIn(ANY_ICAO, standName));
+    }
+
+    void clear() { byIcao_.clear(); }
+    bool empty() const { return byIcao_.empty(); }
+
+private:
+    inline static const std::string ANY_ICAO;
+
+    bool containsIn(const std::string& icao, const std::string& standName) const
+    {
+        auto it = byIcao_.find(icao);
+        return it != byIcao_.end() && it->second.count(standName) != 0;
+    }
+
+    std::unordered_map<std::string, std::unordered_set<std::string>> byIcao_;
+};
+
+} // namespace rampAgent
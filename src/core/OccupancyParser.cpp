@@ -0,0 +1,176 @@
+#include "core/OccupancyParser.h"
+
+#include <nlohmann/json.hpp>
+
+namespace rampAgent {
+
+void OccupancyDocument::clear()
+{
+    entries.clear();
+    removed.clear();
+    version.clear();
+    delta = false;
+}
+
+namespace {
+
+bool listKind(const std::string& key, OccupancyKind& kind)
+{
+    if (key == "assignedStands") { kind = OccupancyKind::Assigned; return true; }
+    if (key == "occupiedStands") { kind = OccupancyKind::Occupied; return true; }
+    if (key == "blockedStands") { kind = OccupancyKind::Blocked; return true; }
+    return false;
+}
+
+class OccupancySaxHandler : public nlohmann::json_sax<nlohmann::json> {
+public:
+    explicit OccupancySaxHandler(OccupancyDocument& document) : document_(document) {}
+
+    bool null() override { return true; }
+
+    bool boolean(bool val) override
+    {
+        if (top() == Frame::Root && key_ == "delta") document_.delta = val;
+        return true;
+    }
+
+    bool number_integer(number_integer_t val) override
+    {
+        if (top() == Frame::Root && key_ == "version") document_.version = std::to_string(val);
+        return true;
+    }
+
+    bool number_unsigned(number_unsigned_t val) override
+    {
+        if (top() == Frame::Root && key_ == "version") document_.version = std::to_string(val);
+        return true;
+    }
+
+    bool number_float(number_float_t, const string_t&) override { return true; }
+
+    bool string(string_t& val) override
+    {
+        if (top() == Frame::Entry) {
+            if (key_ == "callsign") entry_->callsign = std::move(val);
+            else if (key_ == "name") entry_->stand = std::move(val);
+            else if (key_ == "remark") entry_->remark = std::move(val);
+            else if (key_ == "icao") entry_->icao = std::move(val);
+        }
+        else if (top() == Frame::Root && key_ == "version") {
+            document_.version = std::move(val);
+        }
+        return true;
+    }
+
+    bool binary(binary_t&) override { return true; }
+
+    bool start_object(std::size_t) override
+    {
+        Frame frame = Frame::Skip;
+        switch (top()) {
+        case Frame::None:
+            frame = Frame::Root;
+            break;
+        case Frame::Root:
+            // {"assignedStands": {"added": [...], ...}} in delta documents
+            if (listKind(key_, kind_)) frame = Frame::Changes;
+            break;
+        case Frame::List:
+            frame = Frame::Entry;
+            entry_ = &target_->emplace_back();
+            entry_->kind = kind_;
+            break;
+        default:
+            break;
+        }
+        stack_.push_back(frame);
+        return true;
+    }
+
+    bool end_object() override
+    {
+        if (top() == Frame::Entry) {
+            // An entry without a stand name has nothing to show; removals are matched by callsign
+            if (entry_->stand.empty() && target_ == &document_.entries) target_->pop_back();
+            entry_ = nullptr;
+        }
+        stack_.pop_back();
+        return true;
+    }
+
+    bool start_array(std::size_t) override
+    {
+        Frame frame = Frame::Skip;
+        if (top() == Frame::Root && listKind(key_, kind_)) {
+            frame = Frame::List;
+            target_ = &document_.entries;
+        }
+        else if (top() == Frame::Changes) {
+            if (key_ == "added" || key_ == "changed") {
+                frame = Frame::List;
+                target_ = &document_.entries;
+            }
+            else if (key_ == "removed") {
+                frame = Frame::List;
+                target_ = &document_.removed;
+            }
+        }
+        stack_.push_back(frame);
+        return true;
+    }
+
+    bool end_array() override
+    {
+        stack_.pop_back();
+        return true;
+    }
+
+    bool key(string_t& val) override
+    {
+        const Frame frame = top();
+        if (frame == Frame::Root || frame == Frame::Changes || frame == Frame::Entry) key_.swap(val);
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override
+    {
+        error_ = ex.what();
+        return false;
+    }
+
+    const std::string& error() const { return error_; }
+
+private:
+    enum class Frame : uint8_t {
+        None,    // before the first token
+        Root,    // top-level object
+        Changes, // per-list object of a delta document
+        List,    // array of entries
+        Entry,   // one entry object
+        Skip     // anything else, ignored with its children
+    };
+
+    Frame top() const { return stack_.empty() ? Frame::None : stack_.back(); }
+
+    OccupancyDocument& document_;
+    std::vector<Frame> stack_;
+    std::string key_;
+    OccupancyKind kind_ = OccupancyKind::Assigned;
+    std::vector<OccupancyEntry>* target_ = nullptr;
+    OccupancyEntry* entry_ = nullptr;
+    std::string error_;
+};
+
+} // namespace
+
+bool parseOccupancy(const std::string& body, OccupancyDocument& document, std::string* error)
+{
+    document.clear();
+
+    OccupancySaxHandler handler(document);
+    const bool ok = nlohmann::json::sax_parse(body, &handler);
+    if (!ok && error) *error = handler.error();
+    return ok;
+}
+
+} // namespace rampAgent
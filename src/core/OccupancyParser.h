@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rampAgent {
+
+enum class OccupancyKind : uint8_t {
+    Assigned,
+    Occupied,
+    Blocked
+};
+
+struct OccupancyEntry {
+    std::string callsign; // empty for blocked stands
+    std::string stand;
+    std::string remark;
+    std::string icao;     // empty when the server did not report it
+    OccupancyKind kind = OccupancyKind::Assigned;
+};
+
+// One occupancy document from the poll or the stream.
+// Full documents only fill entries; deltas ({"delta": true}) put added and
+// changed entries in entries and the ones to drop in removed.
+struct OccupancyDocument {
+    std::vector<OccupancyEntry> entries;
+    std::vector<OccupancyEntry> removed;
+    std::string version;
+    bool delta = false;
+
+    void clear();
+};
+
+// Decodes an occupancy body straight into typed entries through nlohmann's SAX
+// interface: no DOM is built and unknown fields are skipped without copying.
+// Entries without a string "name" are dropped, except in a delta's removed list.
+// document is cleared first; its vectors keep their capacity across calls.
+bool parseOccupancy(const std::string& body, OccupancyDocument& document, std::string* error = nullptr);
+
+} // namespace rampAgent
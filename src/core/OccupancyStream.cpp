@@ -0,0 +1,172 @@
+#include "core/OccupancyStream.h"
+
+#include <algorithm>
+#include <httplib.h>
+
+#include "core/ApiClient.h"
+
+namespace rampAgent {
+
+void SseParser::feed(const char* data, size_t size)
+{
+    buffer_.append(data, size);
+
+    size_t start = 0, end;
+    while ((end = buffer_.find('\n', start)) != std::string::npos) {
+        std::string_view line(buffer_.data() + start, end - start);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        handleLine(line);
+        start = end + 1;
+    }
+    buffer_.erase(0, start);
+}
+
+void SseParser::reset()
+{
+    buffer_.clear();
+    event_.clear();
+    data_.clear();
+    hasData_ = false;
+}
+
+void SseParser::handleLine(std::string_view line)
+{
+    if (line.empty()) { // blank line ends the event
+        dispatch();
+        return;
+    }
+    if (line.front() == ':') return; // comment, used as heartbeat
+
+    const size_t colon = line.find(':');
+    std::string_view field = line.substr(0, colon);
+    std::string_view value = colon == std::string_view::npos ? std::string_view() : line.substr(colon + 1);
+    if (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+
+    if (field == "event") {
+        event_.assign(value);
+    }
+    else if (field == "data") {
+        if (hasData_) data_.push_back('\n');
+        data_.append(value);
+        hasData_ = true;
+    }
+}
+
+void SseParser::dispatch()
+{
+    if (hasData_) {
+        listener_(event_.empty() ? "message" : event_, data_);
+    }
+    event_.clear();
+    data_.clear();
+    hasData_ = false;
+}
+
+OccupancyStream::OccupancyStream(EventListener onEvent, StateListener onState)
+    : onEvent_(std::move(onEvent)), onState_(std::move(onState))
+{
+}
+
+OccupancyStream::~OccupancyStream()
+{
+    stop();
+}
+
+void OccupancyStream::start(const std::string& url, const std::string& path)
+{
+    const std::string target = ApiClient::schemeHostPort(url) + path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (worker_.joinable() && !stop_ && target_ == target) return;
+    }
+
+    stop();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = false;
+    running_ = true;
+    target_ = target;
+    worker_ = std::thread(&OccupancyStream::run, this, ApiClient::schemeHostPort(url), path);
+}
+
+void OccupancyStream::stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stop_ = true;
+        cv_.notify_all();
+
+        // Cutting the socket is retried in case the request had not opened it yet
+        while (running_) {
+            if (activeClient_) activeClient_->stop();
+            cv_.wait_for(lock, std::chrono::milliseconds(100));
+        }
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    connected_ = false;
+}
+
+void OccupancyStream::setConnected(bool connected)
+{
+    if (connected_.exchange(connected) != connected && onState_) {
+        onState_(connected);
+    }
+}
+
+void OccupancyStream::run(std::string baseUrl, std::string path)
+{
+    runLoop(baseUrl, path);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+    cv_.notify_all();
+}
+
+void OccupancyStream::runLoop(const std::string& baseUrl, const std::string& path)
+{
+    SseParser parser(onEvent_);
+    std::chrono::seconds retryDelay = MIN_RETRY_DELAY;
+
+    while (true) {
+        httplib::Client client(baseUrl);
+        client.set_connection_timeout(ApiClient::CONNECTION_TIMEOUT_S);
+        client.set_read_timeout(READ_TIMEOUT_S);
+        client.set_default_headers({ {"User-Agent", "NeoRampAgent"} });
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stop_) return;
+            activeClient_ = &client;
+        }
+
+        parser.reset();
+        bool wasConnected = false;
+        client.Get(path, { {"Accept", "text/event-stream"} },
+            [&](const httplib::Response& response) {
+                // Anything but a 200 means the server does not stream, keep polling
+                if (response.status != 200) return false;
+                wasConnected = true;
+                setConnected(true);
+                return true;
+            },
+            [&](const char* data, size_t size) {
+                parser.feed(data, size);
+                return true;
+            });
+
+        setConnected(false);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            activeClient_ = nullptr;
+        }
+
+        // A stream that was up reconnects quickly, a refused one backs off
+        retryDelay = wasConnected ? MIN_RETRY_DELAY : std::min(retryDelay * 2, MAX_RETRY_DELAY);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (cv_.wait_for(lock, retryDelay, [this] { return stop_; })) return;
+    }
+}
+
+} // namespace rampAgent
@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace httplib { class Client; }
+
+namespace rampAgent {
+
+// Incremental text/event-stream parser, fed with whatever chunks the socket delivers
+class SseParser {
+public:
+    using Listener = std::function<void(const std::string& event, const std::string& data)>;
+
+    explicit SseParser(Listener listener) : listener_(std::move(listener)) {}
+
+    void feed(const char* data, size_t size);
+    void reset();
+
+private:
+    void handleLine(std::string_view line);
+    void dispatch();
+
+    Listener listener_;
+    std::string buffer_;
+    std::string event_;
+    std::string data_;
+    bool hasData_ = false;
+};
+
+// Server-Sent Events subscription to occupancy changes.
+// Holds its own connection on a dedicated thread, outside the request pool,
+// and reconnects with exponential backoff when the stream drops or is refused.
+class OccupancyStream {
+public:
+    using EventListener = SseParser::Listener;
+    using StateListener = std::function<void(bool connected)>;
+
+    static constexpr std::chrono::seconds MIN_RETRY_DELAY{ 2 };
+    static constexpr std::chrono::seconds MAX_RETRY_DELAY{ 300 };
+    static constexpr int READ_TIMEOUT_S = 45; // server heartbeats are expected well within this
+
+    OccupancyStream(EventListener onEvent, StateListener onState);
+    ~OccupancyStream();
+
+    OccupancyStream(const OccupancyStream&) = delete;
+    OccupancyStream& operator=(const OccupancyStream&) = delete;
+
+    // Subscribes to url + path, a no-op when already subscribed to the same target
+    void start(const std::string& url, const std::string& path);
+    void stop();
+    bool connected() const { return connected_.load(); }
+
+private:
+    void run(std::string baseUrl, std::string path);
+    void runLoop(const std::string& baseUrl, const std::string& path);
+    void setConnected(bool connected);
+
+    EventListener onEvent_;
+    StateListener onState_;
+    std::thread worker_;
+    std::atomic<bool> connected_{ false };
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    bool running_ = false; // worker thread still inside run()
+    std::string target_;
+    httplib::Client* activeClient_ = nullptr; // guarded by mutex_, lets stop() cut a blocking read
+};
+
+} // namespace rampAgent
@@ -0,0 +1,86 @@
+#include "core/PollInterval.h"
+
+#include <algorithm>
+
+namespace rampAgent {
+
+void PollInterval::onSuccess(bool changed, int inboundSoon)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    failures_ = 0;
+    unchanged_ = changed ? 0 : unchanged_ + 1;
+
+    if (inboundSoon >= ARRIVAL_RUSH) {
+        setLocked(minimum_, std::to_string(inboundSoon) + " inbound flights close to landing");
+    }
+    else if (unchanged_ == 0) {
+        setLocked(DEFAULT_BASE / 2, "last poll brought changes");
+    }
+    else if (unchanged_ < QUIET_AFTER || inboundSoon > 0) {
+        setLocked(DEFAULT_BASE, "default");
+    }
+    else {
+        // Grows with each unchanged poll, up to the maximum
+        setLocked(DEFAULT_BASE * (unchanged_ - QUIET_AFTER + 2), std::to_string(unchanged_) + " polls without change");
+    }
+}
+
+void PollInterval::onFailure()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    unchanged_ = 0;
+    ++failures_;
+    const int exponent = std::min(failures_, 10);
+    setLocked(DEFAULT_BASE * (1 << (exponent - 1)), "backing off after " + std::to_string(failures_) + " failed poll(s)");
+}
+
+void PollInterval::onStreaming()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    failures_ = 0;
+    unchanged_ = 0;
+    setLocked(DEFAULT_BASE, "stream connected, polling only refreshes tags");
+}
+
+bool PollInterval::setBounds(Duration minimum, Duration maximum)
+{
+    if (minimum <= Duration::zero() || minimum > maximum) return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    minimum_ = minimum;
+    maximum_ = maximum;
+    setLocked(current_, reason_);
+    return true;
+}
+
+PollInterval::Duration PollInterval::current() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_;
+}
+
+std::string PollInterval::reason() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reason_;
+}
+
+PollInterval::Duration PollInterval::minimum() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return minimum_;
+}
+
+PollInterval::Duration PollInterval::maximum() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return maximum_;
+}
+
+void PollInterval::setLocked(Duration interval, std::string reason)
+{
+    current_ = std::clamp(interval, minimum_, maximum_);
+    reason_ = std::move(reason);
+}
+
+} // namespace rampAgent
@@ -0,0 +1,47 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <string>
+
+namespace rampAgent {
+
+// Occupancy poll period adapted to what the last polls saw.
+// Shortened during arrival rushes and while changes keep coming, lengthened
+// when nothing moves, and backed off exponentially while the server fails.
+// Always kept within [minimum, maximum].
+class PollInterval {
+public:
+    using Duration = std::chrono::seconds;
+
+    static constexpr Duration DEFAULT_MINIMUM{ 5 };
+    static constexpr Duration DEFAULT_BASE{ 15 };
+    static constexpr Duration DEFAULT_MAXIMUM{ 120 };
+    static constexpr int ARRIVAL_RUSH = 5;    // inbound flights close to landing
+    static constexpr int QUIET_AFTER = 4;     // unchanged polls in a row before slowing down
+
+    // inboundSoon: flights expected on a stand within the next minutes
+    void onSuccess(bool changed, int inboundSoon);
+    void onFailure();
+    void onStreaming();
+
+    // Returns false when minimum > maximum or minimum is zero
+    bool setBounds(Duration minimum, Duration maximum);
+
+    Duration current() const;
+    std::string reason() const;
+    Duration minimum() const;
+    Duration maximum() const;
+
+private:
+    void setLocked(Duration interval, std::string reason);
+
+    mutable std::mutex mutex_;
+    Duration minimum_ = DEFAULT_MINIMUM;
+    Duration maximum_ = DEFAULT_MAXIMUM;
+    Duration current_ = DEFAULT_BASE;
+    std::string reason_ = "default";
+    int failures_ = 0;
+    int unchanged_ = 0;
+};
+
+} // namespace rampAgent
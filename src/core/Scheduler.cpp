@@ -0,0 +1,130 @@
+#include "core/Scheduler.h"
+
+namespace rampAgent {
+
+Scheduler::~Scheduler()
+{
+    stop();
+}
+
+void Scheduler::add(std::string name, Duration interval, Duration jitter, Job job)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry entry{ std::move(name), interval, jitter, std::move(job), {} };
+    entry.next = nextRunLocked(entry, Clock::now());
+    jobs_.push_back(std::move(entry));
+    changed_ = true;
+    cv_.notify_one();
+}
+
+void Scheduler::start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (worker_.joinable()) return;
+    stop_ = false;
+    worker_ = std::thread(&Scheduler::run, this);
+}
+
+void Scheduler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable() && worker_.get_id() != std::this_thread::get_id()) {
+        worker_.join();
+    }
+}
+
+void Scheduler::trigger(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (Entry* entry = findLocked(name)) {
+        entry->next = Clock::now();
+        changed_ = true;
+        cv_.notify_one();
+    }
+}
+
+void Scheduler::setInterval(const std::string& name, Duration interval)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry* entry = findLocked(name);
+    if (!entry || entry->interval == interval) return;
+
+    // Pull the next run in when the period got shorter, a longer one applies after it
+    const Clock::time_point sooner = Clock::now() + interval;
+    entry->interval = interval;
+    if (sooner < entry->next) {
+        entry->next = sooner;
+        changed_ = true;
+        cv_.notify_one();
+    }
+}
+
+Scheduler::Duration Scheduler::interval(const std::string& name) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Entry& entry : jobs_) {
+        if (entry.name == name) return entry.interval;
+    }
+    return Duration::zero();
+}
+
+Scheduler::Entry* Scheduler::findLocked(const std::string& name)
+{
+    for (Entry& entry : jobs_) {
+        if (entry.name == name) return &entry;
+    }
+    return nullptr;
+}
+
+Scheduler::Clock::time_point Scheduler::nextRunLocked(const Entry& entry, Clock::time_point from)
+{
+    Duration jitter = Duration::zero();
+    if (entry.jitter > Duration::zero()) {
+        std::uniform_int_distribution<Duration::rep> spread(0, entry.jitter.count());
+        jitter = Duration(spread(rng_));
+    }
+    return from + entry.interval + jitter;
+}
+
+void Scheduler::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (jobs_.empty()) {
+            cv_.wait(lock, [this] { return stop_ || changed_; });
+            changed_ = false;
+            continue;
+        }
+
+        Clock::time_point due = Clock::time_point::max();
+        for (const Entry& entry : jobs_) due = std::min(due, entry.next);
+
+        changed_ = false;
+        if (cv_.wait_until(lock, due, [this] { return stop_ || changed_; })) {
+            continue; // stopping, or a job was triggered or rescheduled
+        }
+
+        // Jobs are copied out so add() and trigger() stay usable from inside a job
+        const Clock::time_point now = Clock::now();
+        for (size_t i = 0; i < jobs_.size() && !stop_; ++i) {
+            if (jobs_[i].next > now) continue;
+
+            Job job = jobs_[i].job;
+            const std::string name = jobs_[i].name;
+            lock.unlock();
+            job();
+            lock.lock();
+
+            if (Entry* entry = findLocked(name)) {
+                // A trigger() during the run is honoured, otherwise wait a full period
+                if (entry->next <= now) entry->next = nextRunLocked(*entry, Clock::now());
+            }
+        }
+    }
+}
+
+} // namespace rampAgent
@@ -0,0 +1,62 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rampAgent {
+
+// Runs named periodic jobs on one worker thread.
+// The thread sleeps on a condition variable until the next job is due, so
+// stop() and trigger() take effect at once instead of on the next tick.
+// Jobs run one at a time and never overlap with themselves.
+class Scheduler {
+public:
+    using Job = std::function<void()>;
+    using Duration = std::chrono::milliseconds;
+
+    Scheduler() = default;
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Each run is scheduled interval + a random [0, jitter] after the previous one ended
+    void add(std::string name, Duration interval, Duration jitter, Job job);
+    void start();
+    void stop();
+
+    // Runs the job as soon as the worker is free, then resumes its normal period
+    void trigger(const std::string& name);
+    void setInterval(const std::string& name, Duration interval);
+    Duration interval(const std::string& name) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::string name;
+        Duration interval;
+        Duration jitter;
+        Job job;
+        Clock::time_point next;
+    };
+
+    void run();
+    Entry* findLocked(const std::string& name);
+    Clock::time_point nextRunLocked(const Entry& entry, Clock::time_point from);
+
+    std::thread worker_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    bool changed_ = false; // schedule edited while the worker waits
+    std::vector<Entry> jobs_;
+    std::minstd_rand rng_{ std::random_device{}() };
+};
+
+} // namespace rampAgent
@@ -0,0 +1,311 @@
+#include "core/StandAllocator.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <string_view>
+#include <unordered_set>
+
+namespace rampAgent {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Common types by wingspan code, anything else is treated as code C
+constexpr std::pair<std::string_view, char> WINGSPAN_CODES[] = {
+    { "C150", 'A' }, { "C152", 'A' }, { "C172", 'A' }, { "C182", 'A' }, { "DA40", 'A' }, { "DA42", 'A' },
+    { "P28A", 'A' }, { "SR22", 'A' }, { "TBM9", 'A' }, { "PC12", 'A' }, { "C25A", 'A' }, { "C525", 'A' },
+    { "BE20", 'B' }, { "C56X", 'B' }, { "C68A", 'B' }, { "CL35", 'B' }, { "E135", 'B' }, { "E145", 'B' },
+    { "CRJ2", 'B' }, { "F2TH", 'B' }, { "FA7X", 'B' }, { "GLF5", 'B' }, { "SF34", 'B' }, { "GLEX", 'C' },
+    { "AT45", 'C' }, { "AT72", 'C' }, { "AT76", 'C' }, { "DH8D", 'C' }, { "CRJ7", 'C' }, { "CRJ9", 'C' },
+    { "CRJX", 'C' }, { "E170", 'C' }, { "E175", 'C' }, { "E190", 'C' }, { "E195", 'C' }, { "E290", 'C' },
+    { "E295", 'C' }, { "BCS1", 'C' }, { "BCS3", 'C' }, { "A318", 'C' }, { "A319", 'C' }, { "A320", 'C' },
+    { "A321", 'C' }, { "A20N", 'C' }, { "A21N", 'C' }, { "B737", 'C' }, { "B738", 'C' }, { "B739", 'C' },
+    { "B38M", 'C' }, { "B39M", 'C' }, { "B752", 'D' }, { "B763", 'D' }, { "A310", 'D' }, { "MD11", 'D' },
+    { "A332", 'E' }, { "A333", 'E' }, { "A339", 'E' }, { "A359", 'E' }, { "A35K", 'E' }, { "A343", 'E' },
+    { "A346", 'E' }, { "B772", 'E' }, { "B77W", 'E' }, { "B788", 'E' }, { "B789", 'E' }, { "B78X", 'E' },
+    { "A388", 'F' }, { "B748", 'F' },
+};
+
+// ICAO nationality prefixes of Schengen members
+constexpr std::array<std::string_view, 30> SCHENGEN_PREFIXES = {
+    "LO", "EB", "LD", "LK", "EK", "EE", "EF", "LF", "ED", "ET", "LG", "LH", "BI", "LI", "EV",
+    "EY", "EL", "LM", "EH", "EN", "EP", "LP", "LZ", "LJ", "LE", "GC", "ES", "LS", "LB", "LR",
+};
+
+// Airline designator from the callsign, empty for private registrations
+std::string operatorOf(const std::string& callsign)
+{
+    if (callsign.size() < 4) return {};
+    for (size_t i = 0; i < 3; ++i) {
+        if (!std::isalpha(static_cast<unsigned char>(callsign[i]))) return {};
+    }
+    if (!std::isdigit(static_cast<unsigned char>(callsign[3]))) return {};
+    return callsign.substr(0, 3);
+}
+
+int codeIndex(char code)
+{
+    return std::clamp(code - 'A', 0, 5);
+}
+
+} // namespace
+
+char wingspanCode(const std::string& aircraftType)
+{
+    for (const auto& [type, code] : WINGSPAN_CODES) {
+        if (type == aircraftType) return code;
+    }
+    return 'C';
+}
+
+bool isSchengenAirport(const std::string& icao)
+{
+    if (icao.size() < 2) return false;
+    const std::string_view prefix(icao.data(), 2);
+    return std::find(SCHENGEN_PREFIXES.begin(), SCHENGEN_PREFIXES.end(), prefix) != SCHENGEN_PREFIXES.end();
+}
+
+void StandAllocator::syncCatalogues(const std::vector<std::shared_ptr<const StandCatalogue>>& catalogues)
+{
+    std::unordered_set<std::string> seen;
+    for (const auto& catalogue : catalogues) {
+        if (!catalogue || catalogue->stands.empty()) continue;
+        seen.insert(catalogue->icao);
+
+        AirportRules& rules = airports_[catalogue->icao];
+        if (!rules.catalogue || rules.catalogue->revision != catalogue->revision) {
+            rules.build(catalogue);
+        }
+        else {
+            rules.catalogue = catalogue;
+        }
+    }
+
+    for (auto it = airports_.begin(); it != airports_.end();) {
+        if (seen.count(it->first) == 0) it = airports_.erase(it);
+        else ++it;
+    }
+}
+
+void StandAllocator::AirportRules::build(std::shared_ptr<const StandCatalogue> source)
+{
+    catalogue = std::move(source);
+    const std::vector<Stand>& stands = catalogue->stands;
+
+    for (Bitset& bits : byCode) bits.resize(stands.size());
+    schengen.resize(stands.size());
+    nonSchengen.resize(stands.size());
+    openToAll.resize(stands.size());
+    byOperator.clear();
+    largestCode.assign(stands.size(), 5);
+    offsetKm.assign(stands.size(), { 0.0, 0.0 });
+    positioned.assign(stands.size(), false);
+    apronRadiusKm = 0.0;
+
+    // Apron centre from the positioned stands, stand offsets are then plain km
+    size_t positionedCount = 0;
+    centreLatitude = 0.0;
+    centreLongitude = 0.0;
+    for (const Stand& stand : stands) {
+        if (!stand.hasPosition) continue;
+        centreLatitude += stand.latitude;
+        centreLongitude += stand.longitude;
+        ++positionedCount;
+    }
+    if (positionedCount) {
+        centreLatitude /= static_cast<double>(positionedCount);
+        centreLongitude /= static_cast<double>(positionedCount);
+    }
+    const double kmPerDegreeLon = std::cos(centreLatitude * PI / 180.0) * 111.32;
+
+    for (size_t i = 0; i < stands.size(); ++i) {
+        const Stand& stand = stands[i];
+        for (int code = 0; code < 6; ++code) {
+            if (stand.codes & (1u << code)) {
+                byCode[code].set(i);
+                largestCode[i] = code;
+            }
+        }
+        if (stand.schengen != 0) schengen.set(i);
+        if (stand.schengen != 1) nonSchengen.set(i);
+
+        if (stand.operators.empty()) {
+            openToAll.set(i);
+        }
+        for (const std::string& designator : stand.operators) {
+            Bitset& bits = byOperator[designator];
+            if (bits.wordCount() == 0) bits.resize(stands.size());
+            bits.set(i);
+        }
+
+        if (stand.hasPosition) {
+            offsetKm[i] = { (stand.longitude - centreLongitude) * kmPerDegreeLon, (stand.latitude - centreLatitude) * 111.32 };
+            positioned[i] = true;
+            apronRadiusKm = std::max(apronRadiusKm, std::hypot(offsetKm[i].first, offsetKm[i].second));
+        }
+    }
+}
+
+StandAllocator::Scorer::Scorer(const AirportRules& rules, const AllocationRequest& request)
+    : rules_(rules),
+      code_(codeIndex(wingspanCode(request.aircraftType))),
+      sizeOk_(rules.byCode[code_]),
+      areaOk_(isSchengenAirport(request.origin) ? rules.schengen : rules.nonSchengen)
+{
+    const std::string designator = operatorOf(request.callsign);
+    if (auto it = rules.byOperator.find(designator); !designator.empty() && it != rules.byOperator.end()) {
+        operatorStands_ = &it->second;
+    }
+
+    // No runway data in the catalogue: the exit is taken on the apron edge facing the
+    // inbound aircraft, or where the aircraft already is once it is inside that edge
+    if (request.hasPosition && rules.apronRadiusKm > 0.0) {
+        const double x = (request.longitude - rules.centreLongitude) * std::cos(rules.centreLatitude * PI / 180.0) * 111.32;
+        const double y = (request.latitude - rules.centreLatitude) * 111.32;
+        const double distance = std::hypot(x, y);
+        const double scale = distance > rules.apronRadiusKm ? rules.apronRadiusKm / distance : 1.0;
+        exitX_ = x * scale;
+        exitY_ = y * scale;
+        hasExit_ = true;
+    }
+}
+
+template <typename Fn>
+void StandAllocator::Scorer::forEachCandidate(const Bitset& taken, Fn&& fn) const
+{
+    const std::vector<Stand>& stands = rules_.catalogue->stands;
+    for (size_t w = 0; w < sizeOk_.wordCount(); ++w) {
+        uint64_t operatorWord = rules_.openToAll.word(w);
+        if (operatorStands_) operatorWord |= operatorStands_->word(w);
+
+        uint64_t candidates = sizeOk_.word(w) & areaOk_.word(w) & operatorWord & ~taken.word(w);
+        while (candidates) {
+            const size_t i = w * 64 + static_cast<size_t>(std::countr_zero(candidates));
+            candidates &= candidates - 1;
+
+            double score = stands[i].priority * 100.0;
+            if (operatorStands_ && operatorStands_->test(i)) score += 50.0;  // the operator's own stands
+            score -= (rules_.largestCode[i] - code_) * 20.0;                 // leave large stands for large aircraft
+            if (hasExit_ && rules_.positioned[i]) {
+                // Taxi distance from the expected runway exit
+                score -= std::hypot(rules_.offsetKm[i].first - exitX_, rules_.offsetKm[i].second - exitY_) * 10.0;
+            }
+            fn(i, score);
+        }
+    }
+}
+
+std::vector<StandAllocation> StandAllocator::allocate(std::vector<AllocationRequest> requests, const TakenPredicate& taken) const
+{
+    std::vector<StandAllocation> allocations;
+    allocations.reserve(requests.size());
+
+    // Keep previous choices first so they stay stable, then the hardest aircraft to place
+    std::vector<std::pair<int, size_t>> order;
+    order.reserve(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const int rank = (requests[i].preferredStand.empty() ? 0 : 10) + codeIndex(wingspanCode(requests[i].aircraftType));
+        order.emplace_back(-rank, i);
+    }
+    std::sort(order.begin(), order.end(), [&requests](const auto& a, const auto& b) {
+        if (a.first != b.first) return a.first < b.first;
+        return requests[a.second].callsign < requests[b.second].callsign;
+    });
+
+    // Taken stands of each airport, filled once per call and as stands are handed out
+    std::unordered_map<std::string, Bitset> takenByAirport;
+
+    for (const auto& [rank, index] : order) {
+        const AllocationRequest& request = requests[index];
+        auto rulesIt = airports_.find(request.icao);
+        if (rulesIt == airports_.end()) continue;
+        const AirportRules& rules = rulesIt->second;
+
+        auto [takenIt, inserted] = takenByAirport.try_emplace(request.icao);
+        Bitset& takenStands = takenIt->second;
+        if (inserted) {
+            const std::vector<Stand>& stands = rules.catalogue->stands;
+            takenStands.resize(stands.size());
+            for (size_t i = 0; i < stands.size(); ++i) {
+                if (taken(request.icao, stands[i].name)) takenStands.set(i);
+            }
+        }
+
+        if (const Stand* stand = allocateOne(rules, request, takenStands)) {
+            allocations.push_back({ request.callsign, request.icao, stand->name });
+        }
+    }
+    return allocations;
+}
+
+const Stand* StandAllocator::allocateOne(const AirportRules& rules, const AllocationRequest& request, Bitset& taken) const
+{
+    const std::vector<Stand>& stands = rules.catalogue->stands;
+
+    // Keep the previous choice while it is still suitable and free
+    const Scorer scorer(rules, request);
+    const Stand* best = nullptr;
+    size_t bestIndex = 0;
+    double bestScore = 0.0;
+    bool preferred = false;
+    scorer.forEachCandidate(taken, [&](size_t i, double score) {
+        if (preferred) return;
+        if (stands[i].name == request.preferredStand) {
+            preferred = true;
+            score = std::numeric_limits<double>::max();
+        }
+        if (!best || score > bestScore) {
+            best = &stands[i];
+            bestIndex = i;
+            bestScore = score;
+        }
+    });
+
+    if (best) taken.set(bestIndex);
+    return best;
+}
+
+std::vector<std::vector<const Stand*>> StandAllocator::suggest(const std::vector<AllocationRequest>& requests,
+    const TakenPredicate& taken, size_t count) const
+{
+    std::vector<std::vector<const Stand*>> suggestions(requests.size());
+    if (count == 0) return suggestions;
+
+    // Nothing is handed out, so each airport's taken stands are read once and shared
+    std::unordered_map<std::string, Bitset> takenByAirport;
+    std::vector<std::pair<double, size_t>> scored;
+
+    for (size_t r = 0; r < requests.size(); ++r) {
+        const AllocationRequest& request = requests[r];
+        auto rulesIt = airports_.find(request.icao);
+        if (rulesIt == airports_.end()) continue;
+        const AirportRules& rules = rulesIt->second;
+        const std::vector<Stand>& stands = rules.catalogue->stands;
+
+        auto [takenIt, inserted] = takenByAirport.try_emplace(request.icao);
+        Bitset& takenStands = takenIt->second;
+        if (inserted) {
+            takenStands.resize(stands.size());
+            for (size_t i = 0; i < stands.size(); ++i) {
+                if (taken(request.icao, stands[i].name)) takenStands.set(i);
+            }
+        }
+
+        scored.clear();
+        Scorer(rules, request).forEachCandidate(takenStands, [&scored](size_t i, double score) { scored.emplace_back(-score, i); });
+
+        // Only the head is ordered, the catalogue order breaks ties
+        const size_t kept = std::min(count, scored.size());
+        std::partial_sort(scored.begin(), scored.begin() + static_cast<std::ptrdiff_t>(kept), scored.end());
+        suggestions[r].reserve(kept);
+        for (size_t i = 0; i < kept; ++i) suggestions[r].push_back(&stands[scored[i].second]);
+    }
+    return suggestions;
+}
+
+} // namespace rampAgent
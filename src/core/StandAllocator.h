@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/StandCatalogue.h"
+
+namespace rampAgent {
+
+// ICAO aerodrome reference code (wingspan) of a type designator, 'C' when unknown
+char wingspanCode(const std::string& aircraftType);
+// True when the airport lies in the Schengen area, from its ICAO prefix
+bool isSchengenAirport(const std::string& icao);
+
+struct AllocationRequest {
+    std::string callsign;
+    std::string icao;           // destination
+    std::string aircraftType;
+    std::string origin;
+    std::string preferredStand; // previous provisional stand, kept while still suitable
+    bool hasPosition = false;   // aircraft already near the airport, used for proximity
+    double latitude = 0.0;
+    double longitude = 0.0;
+};
+
+struct StandAllocation {
+    std::string callsign;
+    std::string icao;
+    std::string standName;
+};
+
+// Provisional stand allocation computed from the cached catalogues alone,
+// for when the Ramp Agent server cannot be reached.
+// Stand rules are compiled once per catalogue revision into compatibility
+// bitsets (per wingspan code, schengen flag and operator), so each flight
+// only intersects a few words and scores the remaining candidates.
+class StandAllocator {
+public:
+    using TakenPredicate = std::function<bool(const std::string& icao, const std::string& standName)>;
+
+    void syncCatalogues(const std::vector<std::shared_ptr<const StandCatalogue>>& catalogues);
+
+    // Allocates every request whose airport is known, larger aircraft first.
+    // Stands for which taken() returns true are never offered.
+    std::vector<StandAllocation> allocate(std::vector<AllocationRequest> requests, const TakenPredicate& taken) const;
+
+    // Up to count free stands suited to each flight, best first, without handing any out.
+    // One entry per request, empty when its airport is unknown or nothing fits.
+    std::vector<std::vector<const Stand*>> suggest(const std::vector<AllocationRequest>& requests,
+        const TakenPredicate& taken, size_t count) const;
+
+private:
+    class Bitset {
+    public:
+        void resize(size_t bits) { words_.assign((bits + 63) / 64, 0); }
+        void set(size_t bit) { words_[bit / 64] |= uint64_t{ 1 } << (bit % 64); }
+        bool test(size_t bit) const { return (words_[bit / 64] >> (bit % 64)) & 1; }
+        size_t wordCount() const { return words_.size(); }
+        uint64_t word(size_t index) const { return words_[index]; }
+        uint64_t& word(size_t index) { return words_[index]; }
+
+    private:
+        std::vector<uint64_t> words_;
+    };
+
+    struct AirportRules {
+        std::shared_ptr<const StandCatalogue> catalogue;
+        Bitset byCode[6];               // stands accepting wingspan code A..F
+        Bitset schengen;                // stands open to schengen flights
+        Bitset nonSchengen;             // stands open to non-schengen flights
+        Bitset openToAll;               // stands without operator restriction
+        std::unordered_map<std::string, Bitset> byOperator;
+        std::vector<int> largestCode;   // per stand, index of its largest accepted code
+        // Stand positions in km east/north of the apron centre, for taxi distances
+        std::vector<std::pair<double, double>> offsetKm;
+        std::vector<bool> positioned;
+        double centreLatitude = 0.0;
+        double centreLongitude = 0.0;
+        double apronRadiusKm = 0.0;     // farthest positioned stand from the centre
+
+        void build(std::shared_ptr<const StandCatalogue> source);
+    };
+
+    // Stands a flight may use and how they compare, shared by allocate() and suggest()
+    class Scorer {
+    public:
+        Scorer(const AirportRules& rules, const AllocationRequest& request);
+
+        // Calls fn(index, score) for every suitable stand not in taken
+        template <typename Fn>
+        void forEachCandidate(const Bitset& taken, Fn&& fn) const;
+
+    private:
+        const AirportRules& rules_;
+        int code_;
+        const Bitset& sizeOk_;
+        const Bitset& areaOk_;
+        const Bitset* operatorStands_ = nullptr;
+        bool hasExit_ = false;
+        double exitX_ = 0.0;            // expected runway exit, km from the apron centre
+        double exitY_ = 0.0;
+    };
+
+    const Stand* allocateOne(const AirportRules& rules, const AllocationRequest& request, Bitset& taken) const;
+
+    std::unordered_map<std::string, AirportRules> airports_;
+};
+
+} // namespace rampAgent
@@ -0,0 +1,163 @@
+#include "core/StandCatalogue.h"
+
+#include <algorithm>
+#include <cctype>
+#include <locale>
+#include <sstream>
+#include <nlohmann/json.hpp>
+
+namespace rampAgent {
+
+StandSortKey StandSortKey::from(const std::string& s)
+{
+    StandSortKey key;
+    size_t i = 0, n = s.size();
+
+    // Trim leading spaces
+    while (i < n && std::isspace(static_cast<unsigned char>(s[i]))) ++i;
+
+    // Leading number
+    int num = 0;
+    bool hasNum = false;
+    while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) {
+        hasNum = true;
+        int digit = s[i] - '0';
+        if (num > (std::numeric_limits<int>::max() - digit) / 10) {
+            num = std::numeric_limits<int>::max(); // clamp on overflow
+        }
+        else {
+            num = num * 10 + digit;
+        }
+        ++i;
+    }
+    if (hasNum) key.number = num;
+
+    // Immediate letter suffix (A, B, AB, ...), left-aligned so integer order is lexical order
+    int shift = 56;
+    while (i < n && std::isalpha(static_cast<unsigned char>(s[i]))) {
+        const char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(s[i])));
+        if (shift >= 0) {
+            key.suffix |= static_cast<uint64_t>(static_cast<unsigned char>(upper)) << shift;
+            shift -= 8;
+        }
+        else {
+            key.tail.push_back(upper);
+        }
+        ++i;
+    }
+
+    // Remainder (for stable tie-breaking, case-insensitive)
+    key.tail.reserve(key.tail.size() + n - i);
+    for (; i < n; ++i) {
+        key.tail.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(s[i]))));
+    }
+    return key;
+}
+
+bool standLess(const Stand& a, const Stand& b)
+{
+    const StandSortKey& ak = a.sortKey;
+    const StandSortKey& bk = b.sortKey;
+
+    if (ak.number != bk.number) return ak.number < bk.number;
+    // Empty suffix packs to 0, so "2" comes before "2A"
+    if (ak.suffix != bk.suffix) return ak.suffix < bk.suffix;
+    if (ak.tail != bk.tail) return ak.tail < bk.tail;
+    return a.name < b.name;
+}
+
+void sortStandList(std::vector<Stand>& standList)
+{
+    std::sort(standList.begin(), standList.end(), standLess);
+}
+
+namespace {
+
+// Accepts "Coordinates": "lat:lon:radius" or separate lat/lon/radius fields
+void readStandPosition(const nlohmann::json& data, Stand& stand)
+{
+    if (!data.is_object()) return;
+
+    if (auto it = data.find("Coordinates"); it != data.end() && it->is_string()) {
+        // Classic locale, the host may run with a comma decimal separator
+        std::istringstream coordinates(it->get<std::string>());
+        coordinates.imbue(std::locale::classic());
+        double lat = 0.0, lon = 0.0, radius = 0.0;
+        char separator = 0;
+        if (coordinates >> lat >> separator && separator == ':' && coordinates >> lon) {
+            stand.hasPosition = true;
+            stand.latitude = lat;
+            stand.longitude = lon;
+            if (coordinates >> separator && separator == ':' && coordinates >> radius) stand.radius = radius;
+        }
+        return;
+    }
+
+    auto number = [&data](std::initializer_list<const char*> keys, double& out) {
+        for (const char* key : keys) {
+            if (auto it = data.find(key); it != data.end() && it->is_number()) {
+                out = it->get<double>();
+                return true;
+            }
+        }
+        return false;
+    };
+    if (number({ "lat", "latitude" }, stand.latitude) && number({ "lon", "lng", "longitude" }, stand.longitude)) {
+        stand.hasPosition = true;
+        number({ "radius" }, stand.radius);
+    }
+}
+
+// "Code": "CDE", "Schengen": true, "Callsigns": ["AFR", "HOP"], "Priority": 2, all optional
+void readStandRules(const nlohmann::json& data, Stand& stand)
+{
+    if (!data.is_object()) return;
+
+    if (auto it = data.find("Code"); it != data.end() && it->is_string()) {
+        uint8_t codes = 0;
+        for (char c : it->get<std::string>()) {
+            const char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            if (upper >= 'A' && upper <= 'F') codes |= static_cast<uint8_t>(1u << (upper - 'A'));
+        }
+        if (codes != 0) stand.codes = codes;
+    }
+    if (auto it = data.find("Schengen"); it != data.end() && it->is_boolean()) {
+        stand.schengen = it->get<bool>() ? 1 : 0;
+    }
+    if (auto it = data.find("Callsigns"); it != data.end() && it->is_array()) {
+        for (const auto& designator : *it) {
+            if (designator.is_string()) stand.operators.push_back(designator.get<std::string>());
+        }
+    }
+    if (auto it = data.find("Priority"); it != data.end() && it->is_number_integer()) {
+        stand.priority = it->get<int>();
+    }
+}
+
+} // namespace
+
+bool parseStandCatalogue(const std::string& body, StandCatalogue& catalogue)
+{
+    try {
+        nlohmann::json standsJson = nlohmann::json::parse(body);
+        if (!standsJson.is_object() || standsJson.empty()) return false;
+
+        catalogue.stands.clear();
+        catalogue.stands.reserve(standsJson.size());
+        for (const auto& [standName, standData] : standsJson.items()) {
+            Stand& stand = catalogue.stands.emplace_back();
+            stand.name = standName;
+            stand.icao = catalogue.icao;
+            stand.sortKey = StandSortKey::from(standName);
+            readStandPosition(standData, stand);
+            readStandRules(standData, stand);
+        }
+        sortStandList(catalogue.stands); // once per load, menus only filter this order
+        return true;
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+} // namespace rampAgent
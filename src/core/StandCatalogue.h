@@ -0,0 +1,56 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace rampAgent {
+
+// Natural order of a stand name, computed once per stand: 2 < 2A < 2B < 10 < 10A < APRON
+struct StandSortKey {
+    int number = std::numeric_limits<int>::max(); // leading number, bare names go to the end
+    uint64_t suffix = 0;  // up to 8 upper-cased letters packed big-endian, 0 when none
+    std::string tail;     // upper-cased remainder, overflowing suffix letters first
+
+    static StandSortKey from(const std::string& name);
+};
+
+struct Stand {
+    std::string name;
+    std::string icao;
+    bool occupied = false;
+    StandSortKey sortKey;
+
+    // Position from the stand data, used for local occupancy detection
+    bool hasPosition = false;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double radius = 0.0; // metres
+
+    // Allocation rules from the stand data, used by the local allocator
+    static constexpr uint8_t ALL_CODES = 0x3f;
+    uint8_t codes = ALL_CODES;          // accepted ICAO aerodrome reference codes, bit 0 = A ... bit 5 = F
+    int8_t schengen = -1;               // 1 schengen flights only, 0 non-schengen only, -1 both
+    std::vector<std::string> operators; // ICAO airline designators, empty when open to every operator
+    int priority = 0;                   // higher is offered first
+};
+
+// Stand order used by the menu, ties on the key fall back to the original name
+bool standLess(const Stand& a, const Stand& b);
+void sortStandList(std::vector<Stand>& standList);
+
+// Stand list of one airport as served by /api/airports/{icao}/stands
+struct StandCatalogue {
+    std::string icao;
+    std::vector<Stand> stands; // sorted with sortStandList(), keys precomputed
+    std::string etag;
+    std::chrono::steady_clock::time_point fetchedAt;
+    uint64_t revision = 0; // changes only when the content does, not on revalidation
+};
+
+// Parses the body of /api/airports/{icao}/stands into catalogue.stands, sorted, using catalogue.icao.
+// Returns false when the body is malformed or lists no stand.
+bool parseStandCatalogue(const std::string& body, StandCatalogue& catalogue);
+
+} // namespace rampAgent
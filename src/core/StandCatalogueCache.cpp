@@ -0,0 +1,154 @@
+#include "core/StandCatalogueCache.h"
+
+namespace rampAgent {
+
+StandCatalogueCache::StandCatalogueCache(Fetcher fetcher, std::chrono::steady_clock::duration ttl)
+    : fetcher_(std::move(fetcher)), ttl_(ttl)
+{
+    worker_ = std::thread(&StandCatalogueCache::run, this);
+}
+
+StandCatalogueCache::~StandCatalogueCache()
+{
+    stop();
+}
+
+std::shared_ptr<const StandCatalogue> StandCatalogueCache::find(const std::string& icao)
+{
+    if (icao.empty()) return nullptr; // flight plan without a destination
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[icao];
+    if (needsLoad(entry, std::chrono::steady_clock::now())) enqueueLocked(icao, entry);
+    return entry.catalogue;
+}
+
+void StandCatalogueCache::prefetch(const std::string& icao)
+{
+    if (icao.empty()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[icao];
+    if (needsLoad(entry, std::chrono::steady_clock::now())) enqueueLocked(icao, entry);
+}
+
+std::vector<std::shared_ptr<const StandCatalogue>> StandCatalogueCache::loaded()
+{
+    std::vector<std::shared_ptr<const StandCatalogue>> catalogues;
+    std::lock_guard<std::mutex> lock(mutex_);
+    catalogues.reserve(entries_.size());
+    for (const auto& [icao, entry] : entries_) {
+        if (entry.catalogue) catalogues.push_back(entry.catalogue);
+    }
+    return catalogues;
+}
+
+void StandCatalogueCache::seed(std::shared_ptr<StandCatalogue> catalogue)
+{
+    if (!catalogue || catalogue->icao.empty()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[catalogue->icao];
+    if (entry.catalogue) return;
+
+    catalogue->fetchedAt = {}; // already expired
+    catalogue->revision = nextRevision_++;
+    entry.catalogue = std::move(catalogue);
+}
+
+void StandCatalogueCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    queue_.clear();
+    ++generation_;
+}
+
+void StandCatalogueCache::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+bool StandCatalogueCache::needsLoad(const Entry& entry, std::chrono::steady_clock::time_point now) const
+{
+    if (entry.queued) return false;
+    if (entry.lastAttempt != std::chrono::steady_clock::time_point{} && now - entry.lastAttempt < RETRY_DELAY) return false;
+    return !entry.catalogue || now - entry.catalogue->fetchedAt >= ttl_;
+}
+
+void StandCatalogueCache::enqueueLocked(const std::string& icao, Entry& entry)
+{
+    entry.queued = true;
+    queue_.push_back(icao);
+    cv_.notify_one();
+}
+
+void StandCatalogueCache::run()
+{
+    while (true) {
+        std::string icao;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_) return;
+
+            icao = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        load(icao);
+    }
+}
+
+void StandCatalogueCache::load(const std::string& icao)
+{
+    std::shared_ptr<const StandCatalogue> current;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current = entries_[icao].catalogue;
+        generation = generation_;
+    }
+
+    ApiClient::Headers headers;
+    if (current && !current->etag.empty()) {
+        headers.emplace("If-None-Match", current->etag);
+    }
+
+    ApiResponse res = fetcher_("/api/airports/" + icao + "/stands", headers);
+    const auto now = std::chrono::steady_clock::now();
+
+    std::shared_ptr<StandCatalogue> fresh;
+    if (res.status == 304 && current) {
+        // Unchanged on the server, only extend its lifetime
+        fresh = std::make_shared<StandCatalogue>(*current);
+        fresh->fetchedAt = now;
+    }
+    else if (res.ok() && !res.body.empty()) {
+        auto parsed = std::make_shared<StandCatalogue>();
+        parsed->icao = icao;
+        // Malformed data keeps the previous catalogue, retried after RETRY_DELAY
+        if (parseStandCatalogue(res.body, *parsed)) {
+            parsed->etag = res.header("ETag");
+            parsed->fetchedAt = now;
+            fresh = std::move(parsed);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (generation != generation_) return; // cache was cleared while loading
+    if (fresh && fresh->revision == 0) fresh->revision = nextRevision_++;
+
+    Entry& entry = entries_[icao];
+    entry.queued = false;
+    entry.lastAttempt = now;
+    if (fresh) entry.catalogue = std::move(fresh);
+}
+
+} // namespace rampAgent
@@ -0,0 +1,74 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core/ApiClient.h"
+#include "core/StandCatalogue.h"
+
+namespace rampAgent {
+
+// In-memory stand catalogues keyed by ICAO.
+// Lookups never touch the network: a missing or expired catalogue is queued
+// for a background (re)load, revalidated with If-None-Match when an ETag is known.
+class StandCatalogueCache {
+public:
+    using Fetcher = std::function<ApiResponse(const std::string& path, const ApiClient::Headers& headers)>;
+
+    static constexpr std::chrono::minutes DEFAULT_TTL{ 30 };
+    static constexpr std::chrono::seconds RETRY_DELAY{ 60 }; // after a failed load
+
+    explicit StandCatalogueCache(Fetcher fetcher, std::chrono::steady_clock::duration ttl = DEFAULT_TTL);
+    ~StandCatalogueCache();
+
+    StandCatalogueCache(const StandCatalogueCache&) = delete;
+    StandCatalogueCache& operator=(const StandCatalogueCache&) = delete;
+
+    // Returns the cached catalogue (possibly stale) or nullptr, queueing a load as needed.
+    // An empty ICAO is never loaded.
+    std::shared_ptr<const StandCatalogue> find(const std::string& icao);
+    // Queues a background load if the airport is unknown or its catalogue expired
+    void prefetch(const std::string& icao);
+    // Adds a catalogue kept from a previous session unless the airport is already known.
+    // It is served at once and revalidated with its ETag on first use.
+    void seed(std::shared_ptr<StandCatalogue> catalogue);
+    // Every catalogue currently loaded, without queueing anything
+    std::vector<std::shared_ptr<const StandCatalogue>> loaded();
+    // Drops every catalogue, e.g. after the API url changed
+    void clear();
+    void stop();
+
+private:
+    struct Entry {
+        std::shared_ptr<const StandCatalogue> catalogue;
+        std::chrono::steady_clock::time_point lastAttempt;
+        bool queued = false;
+    };
+
+    void run();
+    void load(const std::string& icao);
+    bool needsLoad(const Entry& entry, std::chrono::steady_clock::time_point now) const;
+    void enqueueLocked(const std::string& icao, Entry& entry);
+
+    Fetcher fetcher_;
+    const std::chrono::steady_clock::duration ttl_;
+    std::thread worker_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    uint64_t generation_ = 0; // bumped by clear() so in-flight loads are discarded
+    uint64_t nextRevision_ = 1;
+    std::unordered_map<std::string, Entry> entries_;
+    std::deque<std::string> queue_;
+};
+
+} // namespace rampAgent
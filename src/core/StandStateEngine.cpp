@@ -0,0 +1,778 @@
+#include "core/StandStateEngine.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <set>
+#include <tuple>
+
+namespace rampAgent {
+
+StandStateEngine::StandStateEngine(EngineHost& host, Metrics* metrics)
+    : host_(host), metrics_(metrics)
+{
+}
+
+std::shared_ptr<const OccupancySnapshot> StandStateEngine::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    return snapshot_;
+}
+
+std::shared_ptr<const LocalOccupancyView> StandStateEngine::localOccupancy() const
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    return localOccupancy_;
+}
+
+void StandStateEngine::publish(std::shared_ptr<const OccupancySnapshot> snapshot)
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    snapshot_.swap(snapshot);
+}
+
+bool OccupancySnapshot::isTaken(const std::string& icao, const std::string& standName) const
+{
+    if (auto it = airports.find(icao); it != airports.end() && it->second->takenStands.contains(icao, standName)) return true;
+    // Entries sent without an ICAO match every airport
+    if (icao.empty()) return false;
+    auto it = airports.find(std::string());
+    return it != airports.end() && it->second->takenStands.contains(icao, standName);
+}
+
+void StandStateEngine::buildIndex(AirportOccupancy& airport)
+{
+    for (const OccupancyEntry& entry : airport.entries) {
+        airport.takenStands.add(entry.icao, entry.stand);
+    }
+}
+
+void StandStateEngine::applyDelta(std::vector<OccupancyEntry>& entries, OccupancyDocument& delta)
+{
+    // Entries are identified by list and callsign, blocked stands without one by stand name
+    auto identity = [](const OccupancyEntry& entry) {
+        return std::to_string(static_cast<int>(entry.kind)) + (entry.callsign.empty() ? "S:" + entry.stand : "C:" + entry.callsign);
+    };
+
+    // Changed (and re-sent added) entries are replaced, so drop them together with removed ones
+    std::set<std::string> dropped;
+    for (const OccupancyEntry& entry : delta.removed) dropped.insert(identity(entry));
+    for (const OccupancyEntry& entry : delta.entries) dropped.insert(identity(entry));
+
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+        [&](const OccupancyEntry& entry) { return dropped.count(identity(entry)) != 0; }), entries.end());
+
+    entries.insert(entries.end(), std::make_move_iterator(delta.entries.begin()), std::make_move_iterator(delta.entries.end()));
+}
+
+std::shared_ptr<const OccupancySnapshot> StandStateEngine::commit(const std::shared_ptr<const OccupancySnapshot>& previous,
+    std::map<std::string, std::shared_ptr<const AirportOccupancy>> updated, bool replaceAll)
+{
+    auto fresh = std::make_shared<OccupancySnapshot>();
+    if (!replaceAll && previous) fresh->airports = previous->airports; // shared, not copied
+    for (auto& [icao, airport] : updated) fresh->airports[icao] = std::move(airport);
+
+    for (const auto& [icao, airport] : fresh->airports) fresh->received |= airport->received;
+    fresh->fetchedAt = std::chrono::steady_clock::now();
+    publish(fresh);
+    return fresh;
+}
+
+bool StandStateEngine::ingest(OccupancyResponse response)
+{
+    // Poller and stream feed the same pipeline, one document at a time
+    std::lock_guard<std::mutex> ingestLock(ingestMutex_);
+    std::shared_ptr<const OccupancySnapshot> previous = snapshot();
+
+    std::shared_ptr<const OccupancySnapshot> current;
+    if (response.kind == OccupancyResponse::Kind::NotModified || response.kind == OccupancyResponse::Kind::Delta) {
+        if (!previous) return false;
+    }
+
+    if (response.kind == OccupancyResponse::Kind::NotModified) {
+        // Unchanged on the server: no parsing, no indexing, tags are refreshed from the current snapshot
+        current = previous;
+    }
+    else {
+        std::optional<ScopedTimer> timer;
+        if (metrics_) timer.emplace(metrics_->histogram(Metrics::Stage::Ingest));
+
+        // Position-wide documents are split per airport, a delta only rebuilds the airports it touches
+        const auto now = std::chrono::steady_clock::now();
+        std::map<std::string, OccupancyDocument> perAirport;
+        for (OccupancyEntry& entry : response.document.entries) perAirport[entry.icao].entries.push_back(std::move(entry));
+
+        if (response.kind == OccupancyResponse::Kind::Delta) {
+            for (OccupancyEntry& entry : response.document.removed) {
+                if (!entry.icao.empty()) {
+                    perAirport[entry.icao].removed.push_back(std::move(entry));
+                    continue;
+                }
+                // Removal without an ICAO applies to every airport
+                for (const auto& [icao, airport] : previous->airports) perAirport[icao].removed.push_back(entry);
+                perAirport[entry.icao].removed.push_back(entry);
+            }
+        }
+
+        std::map<std::string, std::shared_ptr<const AirportOccupancy>> updated;
+        for (auto& [icao, document] : perAirport) {
+            auto airport = std::make_shared<AirportOccupancy>();
+            airport->icao = icao;
+            if (response.kind == OccupancyResponse::Kind::Delta) {
+                if (auto it = previous->airports.find(icao); it != previous->airports.end()) {
+                    airport->entries = it->second->entries;
+                    airport->restored = it->second->restored; // a delta does not confirm the rest
+                }
+                applyDelta(airport->entries, document);
+            }
+            else {
+                airport->entries = std::move(document.entries);
+            }
+            airport->version = response.document.version;
+            airport->received = response.kind != OccupancyResponse::Kind::Failed;
+            airport->fetchedAt = now;
+            buildIndex(*airport);
+            updated[icao] = std::move(airport);
+        }
+        current = commit(previous, std::move(updated), response.kind != OccupancyResponse::Kind::Delta);
+    }
+
+    applyToTags(*current);
+    return true;
+}
+
+std::vector<std::string> StandStateEngine::ingestAirports(std::map<std::string, OccupancyResponse> responses)
+{
+    std::vector<std::string> rejected;
+    if (responses.empty()) return rejected;
+
+    std::lock_guard<std::mutex> ingestLock(ingestMutex_);
+    std::shared_ptr<const OccupancySnapshot> previous = snapshot();
+
+    std::map<std::string, std::shared_ptr<const AirportOccupancy>> updated;
+    {
+        std::optional<ScopedTimer> timer;
+        if (metrics_) timer.emplace(metrics_->histogram(Metrics::Stage::Ingest));
+
+        for (auto& [icao, response] : responses) {
+            std::shared_ptr<const AirportOccupancy> previousAirport;
+            if (previous) {
+                if (auto it = previous->airports.find(icao); it != previous->airports.end()) previousAirport = it->second;
+            }
+            if (response.kind == OccupancyResponse::Kind::NotModified || response.kind == OccupancyResponse::Kind::Delta) {
+                if (!previousAirport) {
+                    rejected.push_back(icao);
+                    continue;
+                }
+            }
+            // This airport did not change, its part is shared as it is
+            if (response.kind == OccupancyResponse::Kind::NotModified) continue;
+
+            auto airport = std::make_shared<AirportOccupancy>();
+            if (response.kind == OccupancyResponse::Kind::Failed) {
+                // Last known state is kept but no longer counts as received
+                if (previousAirport) *airport = *previousAirport;
+                airport->icao = icao;
+                airport->received = false;
+                updated[icao] = std::move(airport);
+                continue;
+            }
+
+            for (OccupancyEntry& entry : response.document.entries) {
+                if (entry.icao.empty()) entry.icao = icao;
+            }
+            airport->icao = icao;
+            if (response.kind == OccupancyResponse::Kind::Delta) {
+                airport->entries = previousAirport->entries;
+                airport->restored = previousAirport->restored; // a delta does not confirm the rest
+                applyDelta(airport->entries, response.document);
+            }
+            else {
+                airport->entries = std::move(response.document.entries);
+            }
+            airport->version = response.document.version;
+            airport->received = true;
+            airport->fetchedAt = std::chrono::steady_clock::now();
+            buildIndex(*airport);
+            updated[icao] = std::move(airport);
+        }
+    }
+
+    // Nothing was applicable and nothing to refresh the tags from
+    if (!previous && updated.empty()) return rejected;
+
+    // One tag pass for every airport answered in this round
+    std::shared_ptr<const OccupancySnapshot> current = updated.empty() ? previous : commit(previous, std::move(updated), false);
+    applyToTags(*current);
+    return rejected;
+}
+
+bool StandStateEngine::changesAirport(const std::string& icao, const OccupancyDocument& document) const
+{
+    if (document.delta) return !document.entries.empty() || !document.removed.empty();
+
+    std::shared_ptr<const OccupancySnapshot> current = snapshot();
+    if (!current) return true;
+    auto it = current->airports.find(icao);
+    // A first answer, or one after failures or a restored part, always counts as news
+    if (it == current->airports.end() || !it->second->received || it->second->restored) return true;
+
+    const std::vector<OccupancyEntry>& known = it->second->entries;
+    if (known.size() != document.entries.size()) return true;
+
+    // Stored entries had their airport filled in by ingestAirports()
+    auto key = [&icao](const OccupancyEntry& entry) {
+        return std::tie(entry.icao.empty() ? icao : entry.icao, entry.stand, entry.callsign, entry.kind, entry.remark);
+    };
+    auto less = [&key](const OccupancyEntry* a, const OccupancyEntry* b) { return key(*a) < key(*b); };
+
+    // The server usually keeps its order, only a reordered list needs sorting
+    if (std::equal(known.begin(), known.end(), document.entries.begin(),
+        [&key](const OccupancyEntry& a, const OccupancyEntry& b) { return key(a) == key(b); })) return false;
+
+    std::vector<const OccupancyEntry*> before, after;
+    before.reserve(known.size());
+    after.reserve(known.size());
+    for (const OccupancyEntry& entry : known) before.push_back(&entry);
+    for (const OccupancyEntry& entry : document.entries) after.push_back(&entry);
+    std::sort(before.begin(), before.end(), less);
+    std::sort(after.begin(), after.end(), less);
+    return !std::equal(before.begin(), before.end(), after.begin(),
+        [&key](const OccupancyEntry* a, const OccupancyEntry* b) { return key(*a) == key(*b); });
+}
+
+bool StandStateEngine::restore(std::shared_ptr<const OccupancySnapshot> snapshot)
+{
+    if (!snapshot) return false;
+
+    std::lock_guard<std::mutex> ingestLock(ingestMutex_);
+    if (StandStateEngine::snapshot()) return false; // the server was faster
+
+    publish(snapshot);
+    applyToTags(*snapshot);
+    return true;
+}
+
+bool StandStateEngine::retainAirports(const std::set<std::string>& airports)
+{
+    std::lock_guard<std::mutex> ingestLock(ingestMutex_);
+    std::shared_ptr<const OccupancySnapshot> previous = snapshot();
+    if (!previous) return false;
+
+    // Entries without an ICAO come from position-wide documents and stay
+    std::map<std::string, std::shared_ptr<const AirportOccupancy>> kept = previous->airports;
+    const size_t before = kept.size();
+    std::erase_if(kept, [&airports](const auto& entry) { return !entry.first.empty() && !airports.count(entry.first); });
+    if (kept.size() == before) return false;
+
+    applyToTags(*commit(previous, std::move(kept), true));
+    return true;
+}
+
+void StandStateEngine::refreshTags()
+{
+    // Read under the ingest lock, a snapshot taken before it could be applied over a newer one
+    std::lock_guard<std::mutex> ingestLock(ingestMutex_);
+    std::shared_ptr<const OccupancySnapshot> current = snapshot();
+    if (!current) return;
+
+    applyToTags(*current);
+}
+
+bool StandStateEngine::updateLocalOccupancy()
+{
+    // Grids are only rebuilt for airports whose stands changed
+    localOccupancyEngine_.syncCatalogues(host_.catalogues());
+
+    std::vector<AircraftPosition> positions;
+    if (!localOccupancyEngine_.empty()) positions = host_.positions();
+    std::shared_ptr<const LocalOccupancyView> view = localOccupancyEngine_.detect(positions);
+
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    if (localOccupancy_ && *localOccupancy_ == *view) return false;
+    localOccupancy_ = std::move(view);
+    return true;
+}
+
+void StandStateEngine::updateSuggestions(size_t count)
+{
+    // Rule tables are only rebuilt for airports whose stands changed
+    suggestionRules_.syncCatalogues(host_.catalogues());
+
+    std::shared_ptr<const OccupancySnapshot> occupancy = snapshot();
+    std::shared_ptr<const LocalOccupancyView> local = localOccupancy();
+    // Stands of manual clicks the server did not confirm yet are not offered either
+    std::set<std::pair<std::string, std::string>> pending;
+    {
+        std::unique_lock<std::mutex> lock = lockTagState();
+        for (const auto& [callsign, assignment] : pendingAssignments_) {
+            if (!assignment.standName.empty()) pending.emplace(assignment.icao, assignment.standName);
+        }
+    }
+    auto taken = [&occupancy, &local, &pending](const std::string& icao, const std::string& standName) {
+        return (occupancy && occupancy->isTaken(icao, standName)) || (local && local->isOccupied(icao, standName)) ||
+            (!pending.empty() && pending.count({ icao, standName }));
+    };
+
+    std::vector<AllocationRequest> requests;
+    for (const EngineHost::Flight& flight : host_.flights()) {
+        AllocationRequest& request = requests.emplace_back();
+        request.callsign = flight.callsign;
+        request.icao = flight.destination;
+        request.aircraftType = flight.aircraftType;
+        request.origin = flight.origin;
+        request.hasPosition = true;
+        request.latitude = flight.latitude;
+        request.longitude = flight.longitude;
+    }
+
+    auto fresh = std::make_shared<StandSuggestions>();
+    std::vector<std::vector<const Stand*>> ranked = suggestionRules_.suggest(requests, taken, count);
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (ranked[i].empty()) continue;
+
+        std::vector<std::string>& names = fresh->byCallsign[requests[i].callsign];
+        names.reserve(ranked[i].size());
+        for (const Stand* stand : ranked[i]) names.push_back(stand->name);
+    }
+
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    suggestions_ = std::move(fresh);
+}
+
+std::shared_ptr<const StandSuggestions> StandStateEngine::suggestions() const
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    return suggestions_;
+}
+
+std::map<std::string, std::pair<double, double>> StandStateEngine::referencePoints(const std::string& icao) const
+{
+    // Airport reference point from its first positioned stand
+    std::map<std::string, std::pair<double, double>> airports;
+    for (const auto& catalogue : host_.catalogues()) {
+        if (!icao.empty() && catalogue->icao != icao) continue;
+        for (const Stand& stand : catalogue->stands) {
+            if (stand.hasPosition) {
+                airports.emplace(catalogue->icao, std::make_pair(stand.latitude, stand.longitude));
+                break;
+            }
+        }
+    }
+    return airports;
+}
+
+namespace {
+double distanceKm(const EngineHost::Flight& flight, const std::pair<double, double>& point)
+{
+    const auto& [latitude, longitude] = point;
+    const double x = (flight.longitude - longitude) * std::cos(latitude * 3.14159265358979323846 / 180.0);
+    const double y = flight.latitude - latitude;
+    return std::sqrt(x * x + y * y) * 111.32;
+}
+} // namespace
+
+int StandStateEngine::inboundWithin(double km, const std::string& icao) const
+{
+    const std::map<std::string, std::pair<double, double>> airports = referencePoints(icao);
+    if (airports.empty()) return 0;
+
+    int count = 0;
+    for (const EngineHost::Flight& flight : host_.flights()) {
+        auto airportIt = airports.find(flight.destination);
+        if (airportIt == airports.end() || flight.groundSpeed < 40.0) continue; // on the ground already
+        if (distanceKm(flight, airportIt->second) <= km) ++count;
+    }
+    return count;
+}
+
+std::set<std::string> StandStateEngine::airportsWithTrafficWithin(double km) const
+{
+    std::set<std::string> busy;
+    const std::map<std::string, std::pair<double, double>> airports = referencePoints();
+    if (airports.empty()) return busy;
+
+    for (const EngineHost::Flight& flight : host_.flights()) {
+        // Inbounds in the air, departures and arrivals on the ground
+        const bool onGround = flight.groundSpeed < 40.0;
+        for (const std::string* icao : { &flight.destination, onGround ? &flight.origin : nullptr }) {
+            if (!icao || busy.count(*icao)) continue;
+            auto airportIt = airports.find(*icao);
+            if (airportIt != airports.end() && distanceKm(flight, airportIt->second) <= km) busy.insert(*icao);
+        }
+    }
+    return busy;
+}
+
+std::unique_lock<std::mutex> StandStateEngine::lockTagState()
+{
+    // Only contended acquisitions are timed, the uncontended path stays a single try_lock
+    std::unique_lock<std::mutex> lock(tagMutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        std::optional<ScopedTimer> timer;
+        if (metrics_) timer.emplace(metrics_->histogram(Metrics::Stage::TagLockWait));
+        lock.lock();
+    }
+    return lock;
+}
+
+void StandStateEngine::setTag(const std::string& callsign, const Colour& colour, const std::string& standName, const std::string& remark)
+{
+    tagRenderCache_.set(callsign, colour, standName, remark);
+}
+
+void StandStateEngine::flushTags()
+{
+    std::optional<ScopedTimer> timer;
+    if (metrics_) timer.emplace(metrics_->histogram(Metrics::Stage::TagPush));
+
+    // Only values that differ from what is displayed reach the host, in one batch per cycle
+    tagRenderCache_.flush([this](const TagRenderCache::Update& update) { host_.pushTag(update); });
+}
+
+void StandStateEngine::applyToTags(const OccupancySnapshot& snapshot)
+{
+    std::unique_lock<std::mutex> lock = lockTagState();
+    std::optional<ScopedTimer> timer;
+    if (metrics_) timer.emplace(metrics_->histogram(Metrics::Stage::TagApply));
+
+    if (!snapshot.received) {
+        // Server unreachable: allocate from the cached catalogues instead of clearing every tag
+        applyProvisionalStands();
+        return;
+    }
+
+    const uint64_t pass = ++tagPass_;
+    std::shared_ptr<const LocalOccupancyView> local = localOccupancy();
+    markCallsignsOnScope(pass);
+
+    auto processStand = [&](const OccupancyEntry& stand, bool restored) {
+        const std::string& callsign = stand.callsign;
+        if (callsign.empty()) return;
+
+        // a manual assignment is on its way, the server answer decides this tag
+        if (pendingAssignments_.count(callsign)) return;
+
+        // aircraft must exist on scope, otherwise shown as soon as the host reports it
+        const uint32_t id = names_.intern(callsign);
+        const uint64_t* seen = onScope_.find(id);
+        if (!seen || *seen != pass) {
+            AwaitingTag& awaiting = awaitingTags_[id];
+            awaiting.entry = stand; // reuses the string buffers of the previous pass
+            awaiting.restored = restored;
+            awaiting.pass = pass;
+            return;
+        }
+
+        // Only chosen here, a callsign listed twice still gets a single tag value per pass
+        StandTag& tag = standTags_[id];
+        tag.next = names_.intern(stand.stand);
+        tag.pass = pass;
+        tag.entry = &stand;
+        tag.restored = restored;
+    };
+
+    // display tag item on occupied stands as well, occupied wins over assigned
+    for (OccupancyKind kind : { OccupancyKind::Assigned, OccupancyKind::Occupied }) {
+        for (const auto& [icao, airport] : snapshot.airports) {
+            for (const OccupancyEntry& stand : airport->entries) {
+                if (stand.kind == kind) processStand(stand, airport->restored);
+            }
+        }
+    }
+
+    // Update only if changed or new
+    standTags_.forEach([&](uint32_t, StandTag& tag) {
+        if (tag.pass != pass || !tag.entry) return;
+        const OccupancyEntry& stand = *tag.entry;
+        tag.entry = nullptr; // points into the snapshot of this pass only
+
+        if (tag.restored) {
+            setTag(stand.callsign, STALE, stand.stand, stand.remark);
+        }
+        else if (stand.kind == OccupancyKind::Assigned && isBlockedLocally(stand, local.get())) {
+            setTag(stand.callsign, RED, stand.stand, stand.remark);
+        }
+        else if (tag.stand == tag.next) {
+            setTag(stand.callsign, WHITE, stand.stand, stand.remark);
+        }
+        else {
+            setTag(stand.callsign, YELLOW, stand.stand, stand.remark);
+        }
+    });
+
+    // Awaiting entries the snapshot no longer names are dropped
+    staleIds_.clear();
+    awaitingTags_.forEach([&](uint32_t id, const AwaitingTag& awaiting) {
+        if (awaiting.pass != pass) staleIds_.push_back(id);
+    });
+    for (uint32_t id : staleIds_) awaitingTags_.erase(id);
+
+    commitStandTags(pass);
+    flushTags();
+}
+
+void StandStateEngine::markCallsignsOnScope(uint64_t pass)
+{
+    // Caller holds tagMutex_. One host call for the whole pass, no lookup per entry.
+    host_.callsignsOnScope(scopeCallsigns_);
+    for (const std::string& callsign : scopeCallsigns_) {
+        onScope_[names_.intern(callsign)] = pass;
+    }
+}
+
+void StandStateEngine::commitStandTags(uint64_t pass)
+{
+    // Caller holds tagMutex_. Keep the optimistic tag of pending manual assignments.
+    for (const auto& [callsign, pending] : pendingAssignments_) {
+        if (StandTag* tag = findStandTag(callsign)) {
+            tag->next = tag->stand;
+            tag->pass = pass;
+        }
+    }
+
+    // The pass's choices become the displayed stands, tags it did not choose are cleared
+    staleIds_.clear();
+    standTags_.forEach([&](uint32_t id, StandTag& tag) {
+        if (tag.pass == pass) tag.stand = tag.next;
+        else staleIds_.push_back(id);
+    });
+    for (uint32_t id : staleIds_) {
+        setTag(names_.str(id), WHITE, "");
+        standTags_.erase(id);
+    }
+}
+
+StandStateEngine::StandTag* StandStateEngine::findStandTag(const std::string& callsign)
+{
+    const uint32_t id = names_.find(callsign);
+    return id == StringInterner::NONE ? nullptr : standTags_.find(id);
+}
+
+void StandStateEngine::showStand(const std::string& callsign, const std::string& standName)
+{
+    if (standName.empty()) {
+        const uint32_t id = names_.find(callsign);
+        if (id != StringInterner::NONE) standTags_.erase(id);
+        return;
+    }
+    standTags_[names_.intern(callsign)].stand = names_.intern(standName);
+}
+
+std::string StandStateEngine::shownStand(const std::string& callsign)
+{
+    const StandTag* tag = findStandTag(callsign);
+    return tag ? names_.str(tag->stand) : std::string();
+}
+
+bool StandStateEngine::isBlockedLocally(const OccupancyEntry& stand, const LocalOccupancyView* local) const
+{
+    if (!local || local->occupants.empty()) return false;
+    const std::string icao = stand.icao.empty() ? host_.destinationOf(stand.callsign) : stand.icao;
+    if (icao.empty()) return false;
+    return local->isOccupiedByOther(icao, stand.stand, stand.callsign);
+}
+
+bool StandStateEngine::onCallsignAppeared(const std::string& callsign)
+{
+    std::unique_lock<std::mutex> lock = lockTagState();
+    const uint32_t id = names_.find(callsign);
+    AwaitingTag* awaiting = id == StringInterner::NONE ? nullptr : awaitingTags_.find(id);
+    if (!awaiting) return false;
+    // A flight plan filed before the aircraft connected waits for the aircraft
+    if (pendingAssignments_.count(callsign) || !host_.isOnScope(callsign)) return false;
+
+    const OccupancyEntry stand = std::move(awaiting->entry);
+    const bool restored = awaiting->restored;
+    awaitingTags_.erase(id);
+
+    // New on scope, so shown as a fresh assignment exactly like the next document would
+    std::shared_ptr<const LocalOccupancyView> local = localOccupancy();
+    showStand(callsign, stand.stand);
+    const bool blocked = stand.kind == OccupancyKind::Assigned && isBlockedLocally(stand, local.get());
+    setTag(callsign, restored ? STALE : blocked ? RED : YELLOW, stand.stand, stand.remark);
+    flushTags();
+    return true;
+}
+
+void StandStateEngine::onCallsignGone(const std::string& callsign)
+{
+    std::shared_ptr<const OccupancySnapshot> current = snapshot();
+    std::unique_lock<std::mutex> lock = lockTagState();
+    const uint32_t id = names_.find(callsign);
+    if (id == StringInterner::NONE || !standTags_.erase(id)) return;
+    // The host forgot the tag, the next one is sent in full
+    tagRenderCache_.forget(callsign);
+    if (!current || !current->received) return;
+
+    // Occupied wins over assigned, as in applyToTags()
+    const OccupancyEntry* known = nullptr;
+    bool restored = false;
+    for (const auto& [icao, airport] : current->airports) {
+        for (const OccupancyEntry& stand : airport->entries) {
+            if (stand.callsign != callsign) continue;
+            if (stand.kind == OccupancyKind::Occupied || (stand.kind == OccupancyKind::Assigned && !known)) {
+                known = &stand;
+                restored = airport->restored;
+            }
+        }
+    }
+    if (known) {
+        AwaitingTag& awaiting = awaitingTags_[id];
+        awaiting.entry = *known;
+        awaiting.restored = restored;
+        awaiting.pass = tagPass_;
+    }
+}
+
+void StandStateEngine::applyProvisionalStands()
+{
+    // Caller holds tagMutex_
+    // Provisional stands are recomputed for newcomers on the next cycle
+    awaitingTags_.clear();
+    const uint64_t pass = ++tagPass_;
+    std::shared_ptr<const LocalOccupancyView> local = localOccupancy();
+    standAllocator_.syncCatalogues(host_.catalogues());
+
+    auto choose = [&](const std::string& callsign, const std::string& standName) {
+        StandTag& tag = standTags_[names_.intern(callsign)];
+        tag.next = names_.intern(standName);
+        tag.pass = pass;
+    };
+    auto chosen = [&](const std::string& callsign) {
+        const StandTag* tag = findStandTag(callsign);
+        return tag && tag->pass == pass;
+    };
+
+    // Aircraft already parked show their stand
+    if (local) {
+        for (const auto& [icao, occupants] : local->occupants) {
+            for (const auto& [standName, callsigns] : occupants) {
+                for (const std::string& callsign : callsigns) {
+                    if (pendingAssignments_.count(callsign)) continue;
+                    choose(callsign, standName);
+                    setTag(callsign, WHITE, standName);
+                }
+            }
+        }
+    }
+
+    // Inbound flights on scope get a provisional stand, their last known one while it still fits
+    std::vector<AllocationRequest> requests;
+    for (const EngineHost::Flight& flight : host_.flights()) {
+        if (chosen(flight.callsign) || pendingAssignments_.count(flight.callsign)) continue;
+
+        AllocationRequest& request = requests.emplace_back();
+        request.callsign = flight.callsign;
+        request.icao = flight.destination;
+        request.aircraftType = flight.aircraftType;
+        request.origin = flight.origin;
+        request.preferredStand = shownStand(flight.callsign);
+        request.hasPosition = true;
+        request.latitude = flight.latitude;
+        request.longitude = flight.longitude;
+    }
+
+    const auto allocations = standAllocator_.allocate(std::move(requests),
+        [&local](const std::string& icao, const std::string& standName) {
+            return local && local->isOccupied(icao, standName);
+        });
+    for (const StandAllocation& allocation : allocations) {
+        choose(allocation.callsign, allocation.standName);
+        setTag(allocation.callsign, ORANGE, allocation.standName);
+    }
+
+    commitStandTags(pass);
+    flushTags();
+}
+
+void StandStateEngine::beginAssignment(const std::string& callsign, const std::string& icao, const std::string& standName,
+    const std::function<uint64_t()>& submit)
+{
+    // Submitted under the lock so the result cannot be settled before it is recorded as pending
+    std::unique_lock<std::mutex> lock = lockTagState();
+    std::string previousStand;
+    if (auto pendingIt = pendingAssignments_.find(callsign); pendingIt != pendingAssignments_.end()) {
+        previousStand = pendingIt->second.previousStand;
+    }
+    else {
+        previousStand = shownStand(callsign);
+    }
+
+    std::string upper = standName;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    const std::string shown = upper == "NONE" ? std::string() : standName;
+
+    pendingAssignments_[callsign] = { submit(), previousStand, icao, shown };
+    showStand(callsign, shown);
+    setTag(callsign, GREY, shown);
+    flushTags();
+}
+
+bool StandStateEngine::isPendingStand(const std::string& icao, const std::string& standName)
+{
+    std::unique_lock<std::mutex> lock = lockTagState();
+    for (const auto& [callsign, pending] : pendingAssignments_) {
+        if (pending.standName == standName && pending.icao == icao) return true;
+    }
+    return false;
+}
+
+std::vector<AssignmentResult> StandStateEngine::settleAssignments(const std::vector<AssignmentResult>& results)
+{
+    std::vector<AssignmentResult> settled;
+    if (results.empty()) return settled;
+
+    std::unique_lock<std::mutex> lock = lockTagState();
+    for (const AssignmentResult& result : results) {
+        const std::string& callsign = result.request.callsign;
+        const std::string& standName = result.request.standName;
+
+        // A newer click for this callsign is still in flight and will settle the tag
+        auto pendingIt = pendingAssignments_.find(callsign);
+        if (pendingIt == pendingAssignments_.end() || pendingIt->second.sequence != result.request.sequence) continue;
+        const std::string previousStand = pendingIt->second.previousStand;
+        pendingAssignments_.erase(pendingIt);
+        settled.push_back(result);
+
+        switch (result.outcome) {
+        case AssignmentOutcome::Assigned:
+            showStand(callsign, standName);
+            setTag(callsign, WHITE, standName);
+            continue;
+        case AssignmentOutcome::Freed:
+            showStand(callsign, "");
+            setTag(callsign, WHITE, "");
+            continue;
+        case AssignmentOutcome::Rejected:
+        case AssignmentOutcome::Failed:
+            break;
+        }
+
+        // Roll back to what was displayed before the click
+        showStand(callsign, previousStand);
+        setTag(callsign, WHITE, previousStand);
+    }
+    flushTags();
+    return settled;
+}
+
+std::vector<const Stand*> StandStateEngine::availableStands(const StandCatalogue& catalogue, const OccupancySnapshot& occupancy) const
+{
+    std::vector<const Stand*> available;
+
+    // Parked aircraft seen on scope, still filters the list while the server is unreachable
+    std::shared_ptr<const LocalOccupancyView> local = localOccupancy();
+    if (!occupancy.received && !local) return available;
+
+    // Catalogue is presorted -> 2A,2B, 3A,3B,... filtering keeps that order
+    available.reserve(catalogue.stands.size());
+    for (const Stand& stand : catalogue.stands) {
+        if (occupancy.isTaken(catalogue.icao, stand.name)) continue;
+        if (local && local->isOccupied(catalogue.icao, stand.name)) continue;
+        available.push_back(&stand);
+    }
+    return available;
+}
+
+} // namespace rampAgent
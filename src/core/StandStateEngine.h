@@ -0,0 +1,243 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/AssignmentQueue.h"
+#include "core/FlatIdMap.h"
+#include "core/LocalOccupancy.h"
+#include "core/Metrics.h"
+#include "core/OccupancyIndex.h"
+#include "core/OccupancyParser.h"
+#include "core/StandAllocator.h"
+#include "core/StandCatalogue.h"
+#include "core/StringInterner.h"
+#include "core/TagRenderCache.h"
+
+namespace rampAgent {
+
+typedef std::optional<std::array<unsigned int, 3>> Colour;
+inline Colour YELLOW = std::array<unsigned int, 3>({ 255, 220, 3 });
+inline Colour WHITE = std::array<unsigned int, 3>({ 255, 255, 255 });
+inline Colour GREY = std::array<unsigned int, 3>({ 150, 150, 150 }); // manual assignment awaiting server answer
+inline Colour RED = std::array<unsigned int, 3>({ 230, 60, 60 }); // assigned stand has another aircraft parked on it
+inline Colour ORANGE = std::array<unsigned int, 3>({ 255, 140, 0 }); // provisional stand from the local allocator
+inline Colour STALE = std::array<unsigned int, 3>({ 120, 150, 190 }); // from the previous session, not confirmed yet
+
+// One airport's part of the occupancy view. Replaced as a whole when that
+// airport is refreshed, shared untouched by the snapshots that follow otherwise.
+struct AirportOccupancy {
+    std::string icao;                   // empty for entries the server sent without one
+    std::vector<OccupancyEntry> entries;
+    OccupancyIndex takenStands;         // assigned, occupied and blocked stands
+    std::string version;                // server version this part was built from
+    bool received = false;              // false when the server could not be read
+    bool restored = false;              // read from the disk cache, until the server answers for this airport
+    std::chrono::steady_clock::time_point fetchedAt;
+};
+
+// Immutable view of the followed airports. Built off-lock by the worker and
+// swapped in as a whole, so readers never wait on network I/O.
+struct OccupancySnapshot {
+    std::map<std::string, std::shared_ptr<const AirportOccupancy>> airports;
+    bool received = false;              // at least one airport could be read
+    bool fromDisk = false;              // as read from the disk cache, nothing ingested since
+    std::chrono::steady_clock::time_point fetchedAt;
+
+    bool isTaken(const std::string& icao, const std::string& standName) const;
+
+    template <typename Fn>
+    void forEachEntry(Fn&& fn) const
+    {
+        for (const auto& [icao, airport] : airports) {
+            for (const OccupancyEntry& entry : airport->entries) fn(entry);
+        }
+    }
+};
+
+// Outcome of one occupancy request
+struct OccupancyResponse {
+    enum class Kind {
+        Failed,
+        NotModified, // 304, the current snapshot is still valid
+        Full,
+        Delta        // added/changed/removed entries since the last known version
+    };
+    Kind kind = Kind::Failed;
+    OccupancyDocument document;
+};
+
+// Best free stands per flight, computed in the background and swapped in as a whole
+struct StandSuggestions {
+    std::unordered_map<std::string, std::vector<std::string>> byCallsign;
+};
+
+// Everything the engine asks of the radar client. The plugin answers from the
+// PluginSDK, the bench and headless tools from their own data.
+class EngineHost {
+public:
+    struct Flight {
+        std::string callsign;
+        std::string origin;
+        std::string destination;
+        std::string aircraftType;
+        double latitude = 0.0;
+        double longitude = 0.0;
+        double groundSpeed = 0.0; // knots
+    };
+
+    virtual ~EngineHost() = default;
+
+    virtual bool isOnScope(const std::string& callsign) const = 0;
+    // Replaces callsigns with every callsign on scope, read once per tag pass rather than
+    // looked up entry by entry. The vector is reused between passes.
+    virtual void callsignsOnScope(std::vector<std::string>& callsigns) const = 0;
+    virtual std::string destinationOf(const std::string& callsign) const = 0;
+    // Flights with a flight plan and an aircraft on scope
+    virtual std::vector<Flight> flights() const = 0;
+    virtual std::vector<AircraftPosition> positions() const = 0;
+    virtual std::vector<std::shared_ptr<const StandCatalogue>> catalogues() const = 0;
+    virtual void pushTag(const TagRenderCache::Update& update) = 0;
+};
+
+// Stand state independent of any radar client: occupancy snapshots, local
+// occupancy, provisional allocation, manual assignments and the tag values
+// derived from them. Only talks to the outside through EngineHost.
+class StandStateEngine {
+public:
+    explicit StandStateEngine(EngineHost& host, Metrics* metrics = nullptr);
+
+    StandStateEngine(const StandStateEngine&) = delete;
+    StandStateEngine& operator=(const StandStateEngine&) = delete;
+
+    // Applies one position-wide poll or stream document and refreshes the tags.
+    // Returns false for a 304 or delta with no snapshot to apply it to.
+    bool ingest(OccupancyResponse response);
+    // Same for the documents of some airports, the others are left as they are and the tags
+    // refreshed once. Returns the airports whose 304 or delta had nothing to apply to.
+    std::vector<std::string> ingestAirports(std::map<std::string, OccupancyResponse> responses);
+    // Whether a parsed document would change an airport's part of the current snapshot.
+    // Full documents are compared entry by entry, in any order; deltas change it when not empty.
+    bool changesAirport(const std::string& icao, const OccupancyDocument& document) const;
+    // Shows a snapshot saved by a previous session until the first document arrives.
+    // Returns false when one already did.
+    bool restore(std::shared_ptr<const OccupancySnapshot> snapshot);
+    // Drops the airports no longer followed, returns true when one was dropped
+    bool retainAirports(const std::set<std::string>& airports);
+    // Reapplies the current snapshot, e.g. for aircraft that appeared since
+    void refreshTags();
+    // Shows the last known stand of a callsign the host just started displaying, without waiting
+    // for the next document. Returns true when a tag was set.
+    bool onCallsignAppeared(const std::string& callsign);
+    // The host dropped the callsign: its stand is kept for when it comes back
+    void onCallsignGone(const std::string& callsign);
+    std::shared_ptr<const OccupancySnapshot> snapshot() const;
+
+    // Recomputes parked aircraft from positions, returns true when the view changed.
+    // Called from one thread at a time.
+    bool updateLocalOccupancy();
+    std::shared_ptr<const LocalOccupancyView> localOccupancy() const;
+
+    // Ranks up to count stands for every flight with a known destination, off the click path.
+    // Called from one thread at a time.
+    void updateSuggestions(size_t count);
+    std::shared_ptr<const StandSuggestions> suggestions() const;
+
+    // Flights airborne within km of a destination with a positioned catalogue, of one airport when icao is set
+    int inboundWithin(double km, const std::string& icao = "") const;
+    // Airports with a positioned catalogue and a flight within km of them, airborne inbound or on the ground
+    std::set<std::string> airportsWithTrafficWithin(double km) const;
+
+    // Shows a manual assignment at once; submit() queues it and returns its sequence
+    void beginAssignment(const std::string& callsign, const std::string& icao, const std::string& standName,
+        const std::function<uint64_t()>& submit);
+    // Confirms or rolls back, returns the results that still mattered (not superseded by a newer click)
+    std::vector<AssignmentResult> settleAssignments(const std::vector<AssignmentResult>& results);
+    // A manual assignment to this stand still waits for the server
+    bool isPendingStand(const std::string& icao, const std::string& standName);
+
+    // Free stands of a catalogue in menu order, empty when nothing is known about occupancy yet
+    std::vector<const Stand*> availableStands(const StandCatalogue& catalogue, const OccupancySnapshot& occupancy) const;
+
+    static void applyDelta(std::vector<OccupancyEntry>& entries, OccupancyDocument& delta);
+    static void buildIndex(AirportOccupancy& airport);
+
+private:
+    // Position of each loaded airport, of one airport when icao is set
+    std::map<std::string, std::pair<double, double>> referencePoints(const std::string& icao = "") const;
+    std::unique_lock<std::mutex> lockTagState();
+    struct StandTag;
+    void applyToTags(const OccupancySnapshot& snapshot);
+    void markCallsignsOnScope(uint64_t pass);
+    // Makes the stands chosen by a pass the displayed ones and clears the tags it left out
+    void commitStandTags(uint64_t pass);
+    StandTag* findStandTag(const std::string& callsign);
+    // Records the displayed stand of a callsign outside a pass, none when standName is empty
+    void showStand(const std::string& callsign, const std::string& standName);
+    std::string shownStand(const std::string& callsign);
+    // Another aircraft parked on the assigned stand, seen locally before the server reports it
+    bool isBlockedLocally(const OccupancyEntry& stand, const LocalOccupancyView* local) const;
+    void applyProvisionalStands();
+    void setTag(const std::string& callsign, const Colour& colour, const std::string& standName, const std::string& remark = "");
+    void flushTags();
+    void publish(std::shared_ptr<const OccupancySnapshot> snapshot);
+    // Applies the updated airports on top of previous and makes the result current, caller holds ingestMutex_
+    std::shared_ptr<const OccupancySnapshot> commit(const std::shared_ptr<const OccupancySnapshot>& previous,
+        std::map<std::string, std::shared_ptr<const AirportOccupancy>> updated, bool replaceAll);
+
+    EngineHost& host_;
+    Metrics* metrics_;
+
+    std::shared_ptr<const OccupancySnapshot> snapshot_;
+    std::shared_ptr<const LocalOccupancyView> localOccupancy_;
+    mutable std::mutex snapshotMutex_; // guards both pointer swaps only, never held across I/O
+    std::mutex ingestMutex_;           // serialises poll and stream documents into the snapshot
+    LocalOccupancyEngine localOccupancyEngine_; // only touched by updateLocalOccupancy()
+    std::shared_ptr<const StandSuggestions> suggestions_; // guarded by snapshotMutex_
+    StandAllocator suggestionRules_; // only touched by updateSuggestions()
+
+    // Tag state, guarded by tagMutex_
+    struct PendingAssignment {
+        uint64_t sequence = 0;
+        std::string previousStand; // restored if the server refuses the assignment
+        std::string icao;
+        std::string standName;     // empty when freeing
+    };
+    // Per-callsign state is keyed by interned id and kept between passes: a pass
+    // only stamps what it saw, so a steady cycle neither allocates nor copies maps.
+    struct StandTag {
+        uint32_t stand = StringInterner::NONE; // displayed stand
+        uint32_t next = StringInterner::NONE;  // stand chosen by the pass in progress
+        uint64_t pass = 0;                     // last pass that chose a stand
+        const OccupancyEntry* entry = nullptr; // winning entry, set and cleared within one pass
+        bool restored = false;
+    };
+    struct AwaitingTag {
+        OccupancyEntry entry;
+        bool restored = false;
+        uint64_t pass = 0;
+    };
+    std::mutex tagMutex_;
+    uint64_t tagPass_ = 0;
+    StringInterner names_;                    // callsigns and stand names
+    FlatIdMap<StandTag> standTags_;           // callsigns with a displayed stand
+    FlatIdMap<uint64_t> onScope_;             // pass in which the host last showed the callsign
+    // Last known entry of callsigns the snapshot names but the host does not show yet
+    FlatIdMap<AwaitingTag> awaitingTags_;
+    std::map<std::string, PendingAssignment> pendingAssignments_;
+    std::vector<std::string> scopeCallsigns_; // reused host answer
+    std::vector<uint32_t> staleIds_;          // reused sweep buffer
+    TagRenderCache tagRenderCache_; // what the host currently displays
+    StandAllocator standAllocator_; // offline fallback
+};
+
+} // namespace rampAgent
@@ -0,0 +1,125 @@
+#include "core/StartupTasks.h"
+
+#include <algorithm>
+
+namespace rampAgent {
+
+StartupTasks::~StartupTasks()
+{
+    stop();
+}
+
+void StartupTasks::add(std::string name, Task task)
+{
+    tasks_.emplace_back(std::move(name), std::move(task));
+}
+
+void StartupTasks::start(ReadyHandler onReady)
+{
+    onReady_ = std::move(onReady);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        remaining_ = tasks_.size();
+        ready_ = tasks_.empty();
+        results_.assign(tasks_.size(), Result{});
+    }
+    if (tasks_.empty()) {
+        if (onReady_) onReady_({}, std::chrono::ceil<std::chrono::milliseconds>(Clock::now() - loadedAt_));
+        return;
+    }
+
+    workers_.reserve(tasks_.size());
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+        workers_.emplace_back(&StartupTasks::run, this, i);
+    }
+}
+
+void StartupTasks::stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stop_ = true;
+        cv_.notify_all();
+
+        // Hooks are called unlocked, a task may be removing its own meanwhile
+        while (remaining_ > 0 && !stopHooks_.empty()) {
+            std::vector<std::function<void()>> cancels;
+            for (const auto& [id, cancel] : stopHooks_) cancels.push_back(cancel);
+            lock.unlock();
+            for (const auto& cancel : cancels) cancel();
+            lock.lock();
+            cv_.wait_for(lock, CANCEL_RETRY, [this] { return remaining_ == 0; });
+        }
+    }
+    for (std::thread& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+    workers_.clear();
+}
+
+bool StartupTasks::waitFor(const std::function<bool()>& condition, Clock::duration timeout, Clock::duration poll)
+{
+    const Clock::time_point deadline = Clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        lock.unlock();
+        const bool done = condition();
+        lock.lock();
+        if (done) return true;
+
+        const Clock::time_point now = Clock::now();
+        if (now >= deadline) return false;
+        cv_.wait_for(lock, std::min<Clock::duration>(poll, deadline - now), [this] { return stop_; });
+    }
+    return false;
+}
+
+StartupTasks::StopHook StartupTasks::onStop(std::function<void()> cancel)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_) return {};
+    const uint64_t id = nextStopHook_++;
+    stopHooks_.emplace(id, std::move(cancel));
+    return { this, id };
+}
+
+void StartupTasks::removeStopHook(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopHooks_.erase(id);
+}
+
+bool StartupTasks::ready() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ready_;
+}
+
+void StartupTasks::run(size_t index)
+{
+    const auto& [name, task] = tasks_[index];
+    const Clock::time_point started = Clock::now();
+
+    std::string outcome;
+    try {
+        outcome = task();
+    }
+    catch (const std::exception& e) {
+        outcome = std::string("failed: ") + e.what();
+    }
+
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_[index] = { name, std::move(outcome), std::chrono::ceil<std::chrono::milliseconds>(Clock::now() - started) };
+        if (--remaining_ == 0) cv_.notify_all(); // stop() may be waiting for it
+        if (remaining_ > 0 || stop_) return;
+        ready_ = true;
+        results = results_;
+    }
+
+    // Last task to finish reports for all of them
+    if (onReady_) onReady_(results, std::chrono::ceil<std::chrono::milliseconds>(Clock::now() - loadedAt_));
+}
+
+} // namespace rampAgent
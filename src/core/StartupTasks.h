@@ -0,0 +1,93 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace rampAgent {
+
+// One-shot work deferred from plugin load: each task runs on its own thread so
+// a slow network call (the GitHub version check) holds up neither Initialize()
+// nor the other tasks. When the last one finishes, the ready handler gets every
+// outcome and the time from plugin load to ready.
+class StartupTasks {
+public:
+    using Clock = std::chrono::steady_clock;
+    // Returns a short outcome for the log and the ready message
+    using Task = std::function<std::string()>;
+
+    struct Result {
+        std::string name;
+        std::string outcome;
+        std::chrono::milliseconds elapsed{ 0 };
+    };
+    using ReadyHandler = std::function<void(const std::vector<Result>& results, std::chrono::milliseconds timeToReady)>;
+
+    static constexpr std::chrono::milliseconds CANCEL_RETRY{ 50 };
+
+    // While alive, stop() interrupts the task's blocking call through the cancel function it was made with
+    class StopHook {
+    public:
+        StopHook() = default;
+        StopHook(StartupTasks* owner, uint64_t id) : owner_(owner), id_(id) {}
+        ~StopHook() { if (owner_) owner_->removeStopHook(id_); }
+        StopHook(StopHook&& other) noexcept : owner_(std::exchange(other.owner_, nullptr)), id_(other.id_) {}
+        StopHook& operator=(StopHook&&) = delete;
+        StopHook(const StopHook&) = delete;
+
+        // False when stop() already ran, the call should not be started
+        explicit operator bool() const { return owner_ != nullptr; }
+
+    private:
+        StartupTasks* owner_ = nullptr;
+        uint64_t id_ = 0;
+    };
+
+    explicit StartupTasks(Clock::time_point loadedAt = Clock::now()) : loadedAt_(loadedAt) {}
+    ~StartupTasks();
+
+    StartupTasks(const StartupTasks&) = delete;
+    StartupTasks& operator=(const StartupTasks&) = delete;
+
+    void add(std::string name, Task task);
+    // Starts every task, onReady runs on the thread of the task that finished last
+    void start(ReadyHandler onReady);
+    // Wakes tasks blocked in waitFor(), interrupts the calls guarded by a StopHook and joins them.
+    // A blocking call without a hook is waited for.
+    void stop();
+
+    // For tasks: waits until condition() holds, checked every poll, false on timeout or stop()
+    bool waitFor(const std::function<bool()>& condition, Clock::duration timeout,
+        Clock::duration poll = std::chrono::milliseconds(100));
+    bool ready() const;
+
+    // For tasks: cancel (e.g. httplib's Client::stop()) is called by stop(), again every CANCEL_RETRY
+    // until the task returns, as a call that is still connecting may not notice the first one
+    StopHook onStop(std::function<void()> cancel);
+
+private:
+    void run(size_t index);
+    void removeStopHook(uint64_t id);
+
+    const Clock::time_point loadedAt_;
+    std::vector<std::pair<std::string, Task>> tasks_;
+    std::vector<std::thread> workers_;
+    ReadyHandler onReady_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    size_t remaining_ = 0;
+    bool ready_ = false;
+    std::vector<Result> results_; // in add() order
+    std::map<uint64_t, std::function<void()>> stopHooks_;
+    uint64_t nextStopHook_ = 0;
+};
+
+} // namespace rampAgent
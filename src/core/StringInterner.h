@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rampAgent {
+
+// Maps callsigns and stand names to small dense ids, so per-callsign state can
+// be keyed and compared by integer. Ids are never reused: a session sees a few
+// thousand distinct names at most, and a known name costs one probe and no allocation.
+class StringInterner {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    uint32_t intern(std::string_view text)
+    {
+        const size_t hash = std::hash<std::string_view>{}(text);
+        if (!slots_.empty()) {
+            for (size_t i = hash & (slots_.size() - 1);; i = (i + 1) & (slots_.size() - 1)) {
+                const uint32_t id = slots_[i];
+                if (id == NONE) break;
+                if (hashes_[id] == hash && strings_[id] == text) return id;
+            }
+        }
+
+        if ((strings_.size() + 1) * 2 > slots_.size()) rehash(slots_.empty() ? 64 : slots_.size() * 2);
+        const uint32_t id = static_cast<uint32_t>(strings_.size());
+        strings_.emplace_back(text);
+        hashes_.push_back(hash);
+        place(id);
+        return id;
+    }
+
+    // Id of an already interned name, NONE otherwise
+    uint32_t find(std::string_view text) const
+    {
+        if (slots_.empty()) return NONE;
+        const size_t hash = std::hash<std::string_view>{}(text);
+        for (size_t i = hash & (slots_.size() - 1);; i = (i + 1) & (slots_.size() - 1)) {
+            const uint32_t id = slots_[i];
+            if (id == NONE) return NONE;
+            if (hashes_[id] == hash && strings_[id] == text) return id;
+        }
+    }
+
+    const std::string& str(uint32_t id) const { return strings_[id]; }
+    size_t size() const { return strings_.size(); }
+
+private:
+    void rehash(size_t capacity)
+    {
+        slots_.assign(capacity, NONE);
+        for (uint32_t id = 0; id < strings_.size(); ++id) place(id);
+    }
+
+    void place(uint32_t id)
+    {
+        size_t i = hashes_[id] & (slots_.size() - 1);
+        while (slots_[i] != NONE) i = (i + 1) & (slots_.size() - 1);
+        slots_[i] = id;
+    }
+
+    std::vector<std::string> strings_; // by id
+    std::vector<size_t> hashes_;       // by id, kept for rehashing and cheap mismatches
+    std::vector<uint32_t> slots_;      // ids, open addressing on the string hash
+};
+
+} // namespace rampAgent
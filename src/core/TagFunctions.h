@@ -1,4 +1,6 @@
 #pragma once
+#include <set>
+
 #include "NeoRampAgent.h"
 
 namespace rampAgent {
@@ -75,92 +77,100 @@ void NeoRampAgent::OnTagDropdownAction(const PluginSDK::Tag::DropdownActionEvent
 	}
 	std::string icao = fpOpt->destination;
 
-	std::string token = generateToken(callsign_);
-
-#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
-    httplib::SSLClient cli(apiUrl_);
-    httplib::Headers headers = { {"User-Agent", "NeoRampAgent"} };
-    std::string apiEndpoint = "/api/assign?stand=" + standName + "&icao=" + icao + "&callsign=" + event->callsign + "&token=" + token + "&client=" + callsign_;
-
-    auto res = cli.Get(apiEndpoint.c_str(), headers);
-
-    if (!res || !(res->status >= 200 && res->status < 300)) {
-        logger_->error("Failed to send manual assign to NeoRampAgent server. HTTP status: " + std::to_string(res ? res->status : 0));
-        return;
-    }
-    else { // assignement processed, check response to see if successful and update tag item if so
-        if (!res->body.empty()) {
-			std::lock_guard<std::mutex> lock(occupiedStandstMutex_);
-            nlohmann::ordered_json dataJson = nlohmann::ordered_json::parse(res->body);
-			if (!dataJson.contains("message")) return; // malformed response
-            if (dataJson["message"]["action"].get<std::string>() == "assign") {
-                logger_->info("Manual stand assignment successful: " + standName + " to " + event->callsign);
-				lastStandTagMap_[event->callsign] = standName;
-				UpdateTagItems(event->callsign, WHITE, standName);
-                return;
-            }
-            else if (dataJson["message"]["action"].get<std::string>() == "free") {
-                logger_->info("Freed stand assignment for: " + event->callsign);
-				lastStandTagMap_.erase(event->callsign);
-				UpdateTagItems(event->callsign, WHITE, "");
-                return;
-            }
-            else {
-				logger_->info("Manual stand rejected: " + dataJson["message"]["message"].get<std::string>());
-                DisplayMessage("Manual stand rejected: " + dataJson["message"]["message"].get<std::string>());
-                return;
-            }
-        }
-    }
-#endif // CPPHTTPLIB_OPENSSL_SUPPORT
-	DisplayMessage("Manual stand assignment failed for " + event->callsign + " to " + standName, "");
-}
+    if (!assignmentQueue_) return;
 
-void NeoRampAgent::TagProcessing(const std::string &callsign, const std::string &actionId, const std::string &userInput)
-{
+    // Show the choice at once, the server answer confirms or rolls it back
+    if (!engine_) return;
+    engine_->beginAssignment(event->callsign, icao, standName,
+        [&] { return assignmentQueue_->submit({ event->callsign, standName, icao }); });
+    if (scheduler_) scheduler_->trigger("suggestions"); // the clicked stand is no longer offered to others
 }
 
-inline void NeoRampAgent::updateStandMenuButtons(const std::string& icao, const nlohmann::ordered_json& occupiedStands)
+AssignmentResult NeoRampAgent::sendAssignment(const AssignmentRequest& request)
 {
-    if (isController_ == false || isConnected_ == false) {
-        return;
-    }
-
-    nlohmann::ordered_json standsJson = nlohmann::ordered_json::object();
+    AssignmentResult result;
 
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
-    httplib::SSLClient cli(apiUrl_);
-    httplib::Headers headers = { {"User-Agent", "NeoRampAgent"} };
-    std::string apiEndpoint = "/api/airports/" + icao + "/stands";
+    const std::string client = callsign();
+    std::string token = generateToken(client);
+    std::string apiEndpoint = "/api/assign?stand=" + request.standName + "&icao=" + request.icao + "&callsign=" + request.callsign + "&token=" + token + "&client=" + client;
+
+    ApiResponse res = getApiClient()->get(apiEndpoint, {}, ApiClient::Priority::Interactive);
 
-    auto res = cli.Get(apiEndpoint.c_str(), headers);
+    if (!res.ok()) {
+        result.message = "HTTP status: " + std::to_string(res.status);
+        return result;
+    }
 
-    if (res && res->status >= 200 && res->status < 300) {
-        if (!printError) {
-            printError = true; // reset error printing flag on success
-            DisplayMessage("Successfully reconnected to NeoRampAgent server.", "");
-            logger_->info("Successfully reconnected to NeoRampAgent server.");
+    // assignement processed, check response to see if successful
+    try {
+        nlohmann::ordered_json dataJson = nlohmann::ordered_json::parse(res.body);
+        if (!dataJson.contains("message")) { // malformed response
+            result.message = "malformed response";
+            return result;
         }
-        try {
-            if (!res->body.empty()) standsJson = nlohmann::ordered_json::parse(res->body);
+        const std::string action = dataJson["message"]["action"].get<std::string>();
+        if (action == "assign") {
+            result.outcome = AssignmentOutcome::Assigned;
         }
-        catch (const std::exception& e) {
-            logger_->error("Failed to parse stands data from NeoRampAgent server: " + std::string(e.what()));
+        else if (action == "free") {
+            result.outcome = AssignmentOutcome::Freed;
         }
-    }
-    else {
-        if (printError) {
-            printError = false; // avoid spamming logs
-            logger_->error("Failed to get stands information from NeoRampAgent server. HTTP status: " + std::to_string(res ? res->status : 0));
+        else {
+            result.outcome = AssignmentOutcome::Rejected;
+            result.message = dataJson["message"]["message"].get<std::string>();
         }
     }
+    catch (const std::exception& e) {
+        result.message = e.what();
+    }
 #else
-    logger_->error("Cannot update stand menu - HTTP client not supported (OpenSSL required).");
-    return;
+    result.message = "HTTP client not supported (OpenSSL required)";
 #endif // CPPHTTPLIB_OPENSSL_SUPPORT
 
-    // If standsJson is missing or not an object, publish a minimal dropdown and return safely
-    if (!standsJson.is_object() || standsJson.empty() || occupiedStands.empty()) {
+    return result;
+}
+
+void NeoRampAgent::processAssignmentResults()
+{
+    if (!assignmentQueue_ || !engine_) return;
+
+    // Results superseded by a newer click are dropped by the engine, the rest are reported
+    for (const AssignmentResult& result : engine_->settleAssignments(assignmentQueue_->drainCompleted())) {
+        const std::string& callsign = result.request.callsign;
+        const std::string& standName = result.request.standName;
+
+        switch (result.outcome) {
+        case AssignmentOutcome::Assigned:
+            logger_->info("Manual stand assignment successful: " + standName + " to " + callsign);
+            break;
+        case AssignmentOutcome::Freed:
+            logger_->info("Freed stand assignment for: " + callsign);
+            break;
+        case AssignmentOutcome::Rejected:
+            logger_->info("Manual stand rejected: " + result.message);
+            DisplayMessage("Manual stand rejected: " + result.message);
+            break;
+        case AssignmentOutcome::Failed:
+            logger_->error("Failed to send manual assign to NeoRampAgent server: " + result.message);
+            DisplayMessage("Manual stand assignment failed for " + callsign + " to " + standName, "");
+            break;
+        }
+    }
+}
+
+void NeoRampAgent::TagProcessing(const std::string &callsign, const std::string &actionId, const std::string &userInput)
+{
+}
+
+PluginSDK::Tag::DropdownDefinition NeoRampAgent::buildStandDropdown(const std::shared_ptr<const StandCatalogue>& catalogue,
+    const OccupancySnapshot& occupancy, const std::shared_ptr<const LocalOccupancyView>& localOccupancy,
+    std::unordered_set<std::string>* available)
+{
+    ScopedTimer timer(metrics_.histogram(Metrics::Stage::DropdownBuild));
+
+    // If the catalogue is not loaded yet, publish a minimal dropdown
+    if (!engine_ || !catalogue || catalogue->stands.empty() || (!occupancy.received && !localOccupancy)) {
         PluginSDK::Tag::DropdownDefinition dropdownDef;
         dropdownDef.title = "STAND";
         dropdownDef.width = 75;
@@ -193,60 +203,10 @@ inline void NeoRampAgent::updateStandMenuButtons(const std::string& icao, const
         style.backgroundColor = std::array<unsigned int, 3>{ 47, 53, 57 }; // Darker grey
         dropdownComponent.style = style;
         dropdownDef.components.push_back(dropdownComponent);
-
-        tagInterface_->UpdateActionDropdown(standMenuId_, dropdownDef);
-
-        if (printError) {
-            printError = false; // avoid spamming logs
-            logger_->error("No stands data received from NeoRampAgent server for airport " + icao);
-        }
-        return;
+        return dropdownDef;
     }
 
-    std::vector<Stand> availableStands;
-
-    const auto itAssigned = occupiedStands.find("assignedStands");
-    const auto itOccupied = occupiedStands.find("occupiedStands");
-    const auto itBlocked  = occupiedStands.find("blockedStands");
-
-    for (auto& [standName, standData] : standsJson.items()) {
-        Stand stand;
-        stand.name = standName;
-        stand.occupied = false;
-
-        // Assigned
-        if (itAssigned != occupiedStands.end() && itAssigned->is_array()) {
-            for (const auto& occ : *itAssigned) {
-                const std::string occName = occ.value("name", "");
-                if (!occName.empty() && occName == stand.name) { stand.occupied = true; break; }
-            }
-        }
-        if (stand.occupied) { continue; }
-
-        // Currently occupied
-        if (itOccupied != occupiedStands.end() && itOccupied->is_array()) {
-            for (const auto& occ : *itOccupied) {
-                const std::string occName = occ.value("name", "");
-                if (!occName.empty() && occName == stand.name) { stand.occupied = true; break; }
-            }
-        }
-        if (stand.occupied) { continue; }
-
-        // Blocked
-        if (itBlocked != occupiedStands.end() && itBlocked->is_array()) {
-            for (const auto& occ : *itBlocked) {
-                const std::string occName = occ.value("name", "");
-                if (!occName.empty() && occName == stand.name) { stand.occupied = true; break; }
-            }
-        }
-
-        if (!stand.occupied) {
-            availableStands.push_back(stand);
-        }
-    }
-
-    // Sort stands alphabetically -> 2A,2B, 3A,3B,...
-    sortStandList(availableStands);
+    const std::vector<const Stand*> availableStands = engine_->availableStands(*catalogue, occupancy);
 
     PluginSDK::Tag::DropdownDefinition dropdownDef;
     dropdownDef.title = "STAND";
@@ -278,17 +238,20 @@ inline void NeoRampAgent::updateStandMenuButtons(const std::string& icao, const
     PluginSDK::Tag::DropdownComponent scrollArea;
     scrollArea.id = "SCROLL";
     scrollArea.type = PluginSDK::Tag::DropdownComponentType::ScrollArea;
+    scrollArea.children.reserve(availableStands.size());
 
-    for (const auto& stand : availableStands) {
-        dropdownComponent.id = stand.name;
+    if (available) available->reserve(availableStands.size());
+    for (const Stand* stand : availableStands) {
+        if (available) available->insert(stand->name);
+        dropdownComponent.id = stand->name;
         dropdownComponent.type = PluginSDK::Tag::DropdownComponentType::Button;
-        dropdownComponent.text = stand.name;
+        dropdownComponent.text = stand->name;
         dropdownComponent.requiresInput = false;
         dropdownComponent.style = style;
         scrollArea.children.push_back(dropdownComponent);
     }
 
-    dropdownDef.components.push_back(scrollArea);
+    dropdownDef.components.push_back(std::move(scrollArea));
     dropdownDef.components.push_back(divider);
 
     // Manual entry
@@ -300,8 +263,115 @@ inline void NeoRampAgent::updateStandMenuButtons(const std::string& icao, const
     style.backgroundColor = std::array<unsigned int, 3>{ 47, 53, 57 }; // Darker grey
     dropdownComponent.style = style;
     dropdownDef.components.push_back(dropdownComponent);
+    return dropdownDef;
+}
+
+std::shared_ptr<const NeoRampAgent::PreparedDropdown> NeoRampAgent::prepareStandDropdown(const std::string& icao, bool* built)
+{
+    std::shared_ptr<const StandCatalogue> catalogue = standCatalogue_ ? standCatalogue_->find(icao) : nullptr;
+    static const std::shared_ptr<const OccupancySnapshot> noSnapshot = std::make_shared<const OccupancySnapshot>();
+    std::shared_ptr<const OccupancySnapshot> snapshot = engine_ ? engine_->snapshot() : nullptr;
+    if (!snapshot) snapshot = noSnapshot;
+    std::shared_ptr<const LocalOccupancyView> localOccupancy = engine_ ? engine_->localOccupancy() : nullptr;
+
+    std::shared_ptr<const PreparedDropdown> current;
+    {
+        std::lock_guard<std::mutex> lock(dropdownMutex_);
+        if (auto it = preparedDropdowns_.find(icao); it != preparedDropdowns_.end()) current = it->second;
+    }
+    if (current && current->catalogue == catalogue && current->snapshot == snapshot && current->localOccupancy == localOccupancy) {
+        return current;
+    }
+    if (built) *built = true;
+
+    auto prepared = std::make_shared<PreparedDropdown>();
+    prepared->catalogue = catalogue;
+    prepared->snapshot = snapshot;
+    prepared->localOccupancy = localOccupancy;
+    prepared->definition = buildStandDropdown(catalogue, *snapshot, localOccupancy, &prepared->available);
+
+    std::lock_guard<std::mutex> lock(dropdownMutex_);
+    preparedDropdowns_[icao] = prepared;
+    return prepared;
+}
+
+void NeoRampAgent::prepareStandDropdowns()
+{
+    if (!showsStandMenu() || !standCatalogue_) return;
+
+    // Destinations on scope with a loaded catalogue; unchanged inputs keep their definition
+    std::set<std::string> destinations;
+    for (const auto& flightplan : flightplanAPI_->getAll()) {
+        if (!flightplan.destination.empty()) destinations.insert(flightplan.destination);
+    }
+    for (const auto& catalogue : standCatalogue_->loaded()) {
+        if (destinations.count(catalogue->icao)) prepareStandDropdown(catalogue->icao);
+    }
+
+    std::lock_guard<std::mutex> lock(dropdownMutex_);
+    std::erase_if(preparedDropdowns_, [&destinations](const auto& entry) { return !destinations.count(entry.first); });
+}
+
+void NeoRampAgent::prepareSuggestedDropdowns()
+{
+    std::shared_ptr<const StandSuggestions> suggestions = engine_ ? engine_->suggestions() : nullptr;
+    if (!suggestions) return;
+
+    std::unordered_map<std::string, std::shared_ptr<const SuggestedDropdown>> previous;
+    {
+        std::lock_guard<std::mutex> lock(dropdownMutex_);
+        previous = suggestedDropdowns_;
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<const SuggestedDropdown>> fresh;
+    for (const auto& flightplan : flightplanAPI_->getAll()) {
+        auto suggestedIt = suggestions->byCallsign.find(flightplan.callsign);
+        if (suggestedIt == suggestions->byCallsign.end() || flightplan.destination.empty()) continue;
+
+        std::shared_ptr<const PreparedDropdown> base = prepareStandDropdown(flightplan.destination);
+        if (base->available.empty()) continue;
+
+        // Ranked against a snapshot that may be older than the menu: only stands it still lists are offered
+        std::vector<std::string> suggested;
+        for (const std::string& standName : suggestedIt->second) {
+            if (base->available.count(standName)) suggested.push_back(standName);
+        }
+        if (suggested.empty()) continue;
+
+        // Same menu, same suggestions: the definition built last time is kept
+        if (auto it = previous.find(flightplan.callsign);
+            it != previous.end() && it->second->base == base && it->second->suggested == suggested) {
+            fresh.emplace(flightplan.callsign, it->second);
+            continue;
+        }
+
+        auto dropdown = std::make_shared<SuggestedDropdown>();
+        dropdown->base = base;
+        dropdown->suggested = std::move(suggested);
+        dropdown->definition = base->definition;
 
-    tagInterface_->UpdateActionDropdown(standMenuId_, dropdownDef);
+        // "None", then the suggestions above the full list
+        std::vector<PluginSDK::Tag::DropdownComponent> section;
+        section.reserve(dropdown->suggested.size() + 1);
+        PluginSDK::Tag::DropdownComponent dropdownComponent;
+        PluginSDK::Tag::DropdownComponentStyle style;
+        style.textAlign = PluginSDK::Tag::DropdownAlignmentType::Center;
+        style.backgroundColor = std::array<unsigned int, 3>{ 38, 74, 56 }; // Dark green, suggested
+        for (const std::string& standName : dropdown->suggested) {
+            dropdownComponent.id = standName;
+            dropdownComponent.type = PluginSDK::Tag::DropdownComponentType::Button;
+            dropdownComponent.text = standName;
+            dropdownComponent.requiresInput = false;
+            dropdownComponent.style = style;
+            section.push_back(dropdownComponent);
+        }
+        section.push_back(dropdown->definition.components[1]); // same divider as below "None"
+        dropdown->definition.components.insert(dropdown->definition.components.begin() + 2, section.begin(), section.end());
+        fresh.emplace(flightplan.callsign, std::move(dropdown));
+    }
+
+    std::lock_guard<std::mutex> lock(dropdownMutex_);
+    suggestedDropdowns_.swap(fresh);
 }
 
 bool NeoRampAgent::OnTagShowDropdown(const std::string& actionId, const std::string& callsign)
@@ -309,14 +379,48 @@ bool NeoRampAgent::OnTagShowDropdown(const std::string& actionId, const std::str
     if (!initialized_) return false;
     if (actionId != standMenuId_) return false;
 
+    const auto clicked = std::chrono::steady_clock::now();
     std::optional<Flightplan::Flightplan> fpOpt = flightplanAPI_->getByCallsign(callsign);
     if (!fpOpt) {
         logger_->error("No flightplan found for " + callsign + " during stand menu update.");
         return false;
     }
+    if (!showsStandMenu()) {
+        return true;
+    }
 
-    std::lock_guard<std::mutex> lock(occupiedStandstMutex_);
-    updateStandMenuButtons(fpOpt->destination, lastOccupiedStands_);
+    // Usually prepared after the last occupancy update, only built here when something changed since
+    bool built = false;
+    std::shared_ptr<const PreparedDropdown> prepared = prepareStandDropdown(fpOpt->destination, &built);
+    if (built) metrics_.increment(Metrics::Counter::DropdownMisses);
+    if (fpOpt->destination.empty()) {
+        logger_->warning("No destination in the flightplan of " + callsign + ", no stand to offer.");
+    }
+    else if (!prepared->catalogue) {
+        logger_->warning("Stands data for airport " + fpOpt->destination + " not loaded yet from NeoRampAgent server");
+    }
+    // Suggestions only when prepared against this very menu and none was clicked for another flight since
+    std::shared_ptr<const SuggestedDropdown> suggested;
+    {
+        std::lock_guard<std::mutex> lock(dropdownMutex_);
+        if (auto it = suggestedDropdowns_.find(callsign); it != suggestedDropdowns_.end()) suggested = it->second;
+    }
+    if (suggested && engine_) {
+        const bool current = suggested->base == prepared && std::none_of(suggested->suggested.begin(), suggested->suggested.end(),
+            [&](const std::string& standName) { return engine_->isPendingStand(fpOpt->destination, standName); });
+        if (!current) {
+            suggested.reset();
+            if (scheduler_) scheduler_->trigger("suggestions");
+        }
+    }
+    tagInterface_->UpdateActionDropdown(standMenuId_, suggested ? suggested->definition : prepared->definition);
+
+    const auto elapsed = std::chrono::steady_clock::now() - clicked;
+    metrics_.histogram(Metrics::Stage::DropdownShow).record(elapsed);
+    if (elapsed > DROPDOWN_FRAME_BUDGET) {
+        logger_->warning("Stand menu for " + fpOpt->destination + " took " +
+            std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()) + "ms to open");
+    }
     return true;
 }
 
@@ -31,11 +31,20 @@ void NeoRampAgent::RegisterTagItems()
 
 
 // TAG ITEM UPDATE FUNCTIONS
-void NeoRampAgent::UpdateTagItems(std::string callsign, Colour colour, std::string standName, std::string remark) {
+// Values the engine found different from what is displayed, one call per callsign
+void NeoRampAgent::pushTag(const TagRenderCache::Update& update) {
     Tag::TagContext tagContext;
-	tagContext.callsign = callsign;
-    tagContext.colour = colour;
-    tagInterface_->UpdateTagValue(standTagId_, standName, tagContext);
-    tagInterface_->UpdateTagValue(remarkTagId_, remark, tagContext);
+    tagContext.callsign = update.callsign;
+    tagContext.colour = update.colour;
+    uint64_t sent = 0;
+    if (update.fields & TagRenderCache::STAND) {
+        tagInterface_->UpdateTagValue(standTagId_, update.standName, tagContext);
+        ++sent;
+    }
+    if (update.fields & TagRenderCache::REMARK) {
+        tagInterface_->UpdateTagValue(remarkTagId_, update.remark, tagContext);
+        ++sent;
+    }
+    metrics_.increment(Metrics::Counter::TagValuesSent, sent);
 }
 }  // namespace rampAgent
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rampAgent {
+
+// Remembers what each callsign's STAND/REMARK items currently show and turns
+// desired states into a batch holding only the values that actually changed.
+class TagRenderCache {
+public:
+    using Colour = std::optional<std::array<unsigned int, 3>>;
+
+    enum Field : uint8_t {
+        STAND = 1 << 0,
+        REMARK = 1 << 1
+    };
+
+    struct Update {
+        std::string callsign;
+        std::string standName;
+        std::string remark;
+        Colour colour;
+        uint8_t fields = 0;
+    };
+
+    // Queues whatever differs from the displayed state, returns false when nothing did
+    bool set(const std::string& callsign, const Colour& colour, const std::string& standName, const std::string& remark)
+    {
+        Rendered& rendered = rendered_[callsign];
+        const bool colourChanged = !rendered.known || rendered.colour != colour;
+
+        uint8_t fields = 0;
+        if (colourChanged || rendered.standName != standName) fields |= STAND;
+        if (colourChanged || rendered.remark != remark) fields |= REMARK;
+        if (fields == 0) return false;
+
+        rendered.known = true;
+        rendered.colour = colour;
+        rendered.standName = standName;
+        rendered.remark = remark;
+        batch_.push_back({ callsign, standName, remark, colour, fields });
+        return true;
+    }
+
+    // Next set() for this callsign sends both values again, e.g. when the host reset the tag
+    void forget(const std::string& callsign) { rendered_.erase(callsign); }
+
+    // Hands the pending batch to send(update) and drops blank entries afterwards
+    template <typename Sender>
+    void flush(Sender&& send)
+    {
+        for (const Update& update : batch_) {
+            send(update);
+        }
+        for (const Update& update : batch_) {
+            auto it = rendered_.find(update.callsign);
+            if (it != rendered_.end() && it->second.standName.empty() && it->second.remark.empty()) rendered_.erase(it);
+        }
+        batch_.clear();
+    }
+
+    size_t pendingCount() const { return batch_.size(); }
+
+private:
+    struct Rendered {
+        bool known = false;
+        std::string standName;
+        std::string remark;
+        Colour colour;
+    };
+
+    std::unordered_map<std::string, Rendered> rendered_;
+    std::vector<Update> batch_;
+};
+
+} // namespace rampAgent